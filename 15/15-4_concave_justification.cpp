@@ -0,0 +1,211 @@
+#include <cassert>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace crn = std::chrono;
+
+// cost of a line of width W when the line width is M. (M - W)^3 as in 15-4 while the line fits;
+// past M a steep linear penalty instead of infinity keeps the cost a convex function of W, so
+// w(i, j) = f(prefix[j] - prefix[i]) satisfies the quadrangle inequality everywhere.
+double LineCost(double W, double M) {
+    constexpr double overflow_slope = 1e100;
+    const double slack = M - W;
+    return slack >= 0 ? slack * slack * slack : -slack * overflow_slope;
+}
+
+// DP of 15-4 with the same cost model, for checking. the inner loop stops once the line
+// overflows, so it is O(n L) for at most L words per line
+double NeatlyCost(const std::vector<double>& widths, double space, double M) {
+    const size_t n = widths.size();
+    std::vector<double> c (n + 1, std::numeric_limits<double>::max());
+    c[0] = 0;
+    for (size_t j = 1; j <= n; j++) {
+        double W = -space;
+        for (size_t i = j; i-- > 0;) {
+            W += widths[i] + space;
+            if (W > M) {
+                break;
+            }
+            c[j] = std::min(c[j], c[i] + (j == n ? 0.0 : LineCost(W, M)));
+        }
+    }
+    return c[n];
+}
+
+// concave least-weight subsequence (Hirschberg and Larmore): c[j] = min_i c[i] + w(i, j).
+// under the quadrangle inequality, once a later candidate i' beats i at some j it beats it at
+// every later j, so the candidates form a deque, each owning a range of future j, and a new
+// candidate takes over a suffix of the ranges found by binary search. O(n log n) overall.
+// returns the first word of every line, with the last line free as in 15-4.
+std::vector<size_t> JustifyBreaks(const std::vector<double>& widths, double space, double M) {
+    const size_t n = widths.size();
+    std::vector<double> prefix (n + 1);
+    for (size_t i = 0; i < n; i++) {
+        assert(widths[i] <= M);
+        prefix[i + 1] = prefix[i] + widths[i] + space;
+    }
+    auto w = [&](size_t i, size_t j) { // words i .. j - 1 on one line
+        return LineCost(prefix[j] - prefix[i] - space, M);
+    };
+    std::vector<double> c (n + 1);
+    std::vector<size_t> p (n + 1);
+    std::deque<std::pair<size_t, size_t>> Q; // (candidate i, first j it owns)
+    Q.emplace_back(0, 1);
+    for (size_t j = 1; j < n; j++) {
+        while (Q.size() > 1 && Q[1].second <= j) {
+            Q.pop_front();
+        }
+        const size_t i = Q.front().first;
+        c[j] = c[i] + w(i, j);
+        p[j] = i;
+        // insert j as a candidate for j + 1 .. n - 1
+        auto better = [&](size_t k) { // does j beat the back candidate at k?
+            return c[j] + w(j, k) <= c[Q.back().first] + w(Q.back().first, k);
+        };
+        while (!Q.empty() && Q.back().second > j && better(Q.back().second)) {
+            Q.pop_back();
+        }
+        if (Q.empty()) {
+            Q.emplace_back(j, j + 1);
+            continue;
+        }
+        size_t lo = std::max(Q.back().second, j + 1);
+        size_t hi = n;
+        while (lo < hi) {
+            const size_t mid = lo + (hi - lo) / 2;
+            if (better(mid)) {
+                hi = mid;
+            } else {
+                lo = mid + 1;
+            }
+        }
+        if (lo < n) {
+            Q.emplace_back(j, lo);
+        }
+    }
+    // the last line costs nothing if it fits
+    size_t last = n ? n - 1 : 0;
+    if (n) {
+        double best = c[last];
+        for (size_t i = n - 1; i-- > 0 && prefix[n] - prefix[i] - space <= M;) {
+            if (c[i] < best) {
+                best = c[i];
+                last = i;
+            }
+        }
+    }
+    std::vector<size_t> starts;
+    for (size_t i = last; n;) {
+        starts.push_back(i);
+        if (!i) {
+            break;
+        }
+        i = p[i];
+    }
+    return {starts.rbegin(), starts.rend()};
+}
+
+// justifies text measured by measure(word), calling emit(line) as each line is produced
+void JustifyText(std::string_view text, double M, const std::function<double(std::string_view)>& measure,
+                 const std::function<void(std::string_view)>& emit) {
+    std::vector<std::string_view> words;
+    for (size_t i = 0; i < text.length();) {
+        while (i < text.length() && std::isspace(static_cast<unsigned char>(text[i]))) {
+            i++;
+        }
+        size_t j = i;
+        while (j < text.length() && !std::isspace(static_cast<unsigned char>(text[j]))) {
+            j++;
+        }
+        if (j > i) {
+            words.push_back(text.substr(i, j - i));
+        }
+        i = j;
+    }
+    std::vector<double> widths (words.size());
+    for (size_t i = 0; i < words.size(); i++) {
+        widths[i] = measure(words[i]);
+    }
+    auto starts = JustifyBreaks(widths, measure(" "), M);
+    std::string line;
+    for (size_t k = 0; k < starts.size(); k++) {
+        const size_t end = k + 1 < starts.size() ? starts[k + 1] : words.size();
+        line.clear();
+        for (size_t i = starts[k]; i < end; i++) {
+            line += words[i];
+            if (i + 1 < end) {
+                line += ' ';
+            }
+        }
+        emit(line);
+    }
+}
+
+void PrintNeatly(const std::string& data, size_t M) {
+    JustifyText(data, static_cast<double>(M), [](std::string_view word) { return static_cast<double>(word.length()); },
+                [](std::string_view line) { std::cout << line << '\n'; });
+}
+
+int main() {
+    std::string data = "The algorithm has found universal application in decoding the convolutional codes used in both CDMA and GSM digital cellular, dial-up modems, satellite, deep-space communications, and 802.11 wireless LANs.";
+
+    PrintNeatly(data, 30);
+
+    // cost of the lines starting at starts, checking that each fits
+    auto breaks_cost = [](const std::vector<double>& widths, double space, double M, const std::vector<size_t>& starts) {
+        double cost = 0;
+        for (size_t k = 0; k < starts.size(); k++) {
+            const size_t end = k + 1 < starts.size() ? starts[k + 1] : widths.size();
+            double W = -space;
+            for (size_t i = starts[k]; i < end; i++) {
+                W += widths[i] + space;
+            }
+            assert(W <= M + 1e-9);
+            cost += k + 1 < starts.size() ? LineCost(W, M) : 0.0;
+        }
+        return cost;
+    };
+
+    std::mt19937 gen(std::random_device{}());
+    std::uniform_real_distribution<> glyph(0.3, 1.0);
+    for (size_t iter = 0; iter < 300; iter++) {
+        const double M = 10.0 + static_cast<double>(gen() % 40);
+        std::vector<double> widths (gen() % 300);
+        for (auto& x : widths) {
+            x = iter % 2 ? static_cast<double>(1 + gen() % 10) : glyph(gen) * static_cast<double>(1 + gen() % 10);
+        }
+        const double space = iter % 2 ? 1.0 : 0.35;
+        const double cost = breaks_cost(widths, space, M, JustifyBreaks(widths, space, M));
+        const double expected = NeatlyCost(widths, space, M);
+        assert(std::abs(cost - expected) <= 1e-6 * std::max(1.0, expected));
+    }
+
+    // a book of a million words set in a proportional font
+    std::vector<double> widths (1'000'000);
+    for (auto& x : widths) {
+        x = glyph(gen) * static_cast<double>(1 + gen() % 12);
+    }
+    // O(n L) for L words per line against O(n log n): narrow columns, then a wide viewport
+    for (double M : {60.0, 3000.0}) {
+        auto t1 = crn::steady_clock::now();
+        auto expected = NeatlyCost(widths, 0.35, M);
+        auto t2 = crn::steady_clock::now();
+        auto starts = JustifyBreaks(widths, 0.35, M);
+        auto t3 = crn::steady_clock::now();
+        const double cost = breaks_cost(widths, 0.35, M, starts);
+        assert(std::abs(cost - expected) <= 1e-6 * std::max(1.0, expected));
+        std::cout << "M = " << M << ", " << starts.size() << " lines, cost " << expected << "\n";
+        std::cout << "Quadratic DP, cut off at the line width : " << crn::duration_cast<crn::milliseconds>(t2 - t1).count() << "ms\n";
+        std::cout << "Concave least-weight subsequence : " << crn::duration_cast<crn::milliseconds>(t3 - t2).count() << "ms\n";
+    }
+}
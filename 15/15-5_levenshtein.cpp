@@ -0,0 +1,276 @@
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace crn = std::chrono;
+
+using u64 = std::uint64_t;
+
+// unit-cost copy, replace, delete and insert
+size_t LevenshteinDistance(std::string_view x, std::string_view y) {
+    const size_t m = x.length();
+    const size_t n = y.length();
+    std::vector<size_t> c (n + 1);
+    for (size_t j = 0; j <= n; j++) {
+        c[j] = j;
+    }
+    for (size_t i = 1; i <= m; i++) {
+        size_t diag = c[0];
+        c[0] = i;
+        for (size_t j = 1; j <= n; j++) {
+            size_t up = c[j];
+            c[j] = std::min({c[j] + 1, c[j - 1] + 1, diag + (x[i - 1] != y[j - 1])});
+            diag = up;
+        }
+    }
+    return c[n];
+}
+
+// one 64-row block of Myers' algorithm for a column of y. Pv/Mv hold the +1/-1 vertical deltas,
+// hin is the horizontal delta entering the block's first row; returns the delta leaving its row top.
+int AdvanceBlock(u64& Pv, u64& Mv, u64 Eq, int hin, u64 top) {
+    const u64 Xv = Eq | Mv;
+    if (hin < 0) {
+        Eq |= 1;
+    }
+    const u64 Xh = (((Eq & Pv) + Pv) ^ Pv) | Eq;
+    u64 Ph = Mv | ~(Xh | Pv);
+    u64 Mh = Pv & Xh;
+    const int hout = (Ph & top) ? 1 : (Mh & top) ? -1 : 0;
+    Ph <<= 1;
+    Mh <<= 1;
+    if (hin < 0) {
+        Mh |= 1;
+    } else if (hin > 0) {
+        Ph |= 1;
+    }
+    Pv = Mh | ~(Xv | Ph);
+    Mv = Ph & Xv;
+    return hout;
+}
+
+// Myers' bit-vector Levenshtein distance: O(ceil(m / 64) n) word operations
+size_t MyersDistance(std::string_view x, std::string_view y) {
+    const size_t m = x.length();
+    if (!m) {
+        return y.length();
+    }
+    const size_t nw = (m + 63) / 64;
+    std::vector<u64> Peq (256 * nw);
+    for (size_t i = 0; i < m; i++) {
+        Peq[static_cast<unsigned char>(x[i]) * nw + i / 64] |= u64 {1} << (i % 64);
+    }
+    std::vector<u64> Pv (nw, ~u64 {0});
+    std::vector<u64> Mv (nw);
+    const u64 last_top = u64 {1} << ((m - 1) % 64);
+    size_t score = m;
+    for (unsigned char c : y) {
+        const u64* eq = Peq.data() + c * nw;
+        int h = 1; // row 0 of the table is 0, 1, 2, ...
+        for (size_t w = 0; w < nw; w++) {
+            h = AdvanceBlock(Pv[w], Mv[w], eq[w], h, w + 1 == nw ? last_top : u64 {1} << 63);
+        }
+        score += h;
+    }
+    return score;
+}
+
+// Ukkonen's band: only cells with |i - j| <= k can hold a value <= k, so each row touches
+// 2k + 1 cells, and the scan stops once a whole band row exceeds k. returns min(d, k + 1).
+size_t BandedDistance(std::string_view x, std::string_view y, size_t k) {
+    const size_t m = x.length();
+    const size_t n = y.length();
+    const size_t cap = k + 1;
+    if ((m > n ? m - n : n - m) > k) {
+        return cap;
+    }
+    std::vector<size_t> prev (n + 1, cap);
+    std::vector<size_t> cur (n + 1, cap);
+    for (size_t j = 0; j <= std::min(n, k); j++) {
+        prev[j] = j;
+    }
+    for (size_t i = 1; i <= m; i++) {
+        const size_t lo = i > k ? i - k : 1;
+        const size_t hi = std::min(n, i + k);
+        cur[lo - 1] = (lo == 1 && i <= k) ? i : cap;
+        size_t row_min = cur[lo - 1];
+        for (size_t j = lo; j <= hi; j++) {
+            cur[j] = std::min({prev[j] + 1, cur[j - 1] + 1, prev[j - 1] + (x[i - 1] != y[j - 1]), cap});
+            row_min = std::min(row_min, cur[j]);
+        }
+        if (hi < n) {
+            cur[hi + 1] = cap;
+        }
+        if (row_min > k) {
+            return cap;
+        }
+        std::swap(prev, cur);
+    }
+    return prev[n];
+}
+
+// distances from one query to many candidates, capped at k + 1. for queries of up to 64 bytes
+// the candidates run through Myers' recurrence in groups of `lanes`, one candidate per lane,
+// so the lane loops vectorize; lanes whose lower bound passes k are retired early.
+std::vector<size_t> BatchDistance(std::string_view query, const std::vector<std::string>& candidates, size_t k) {
+    constexpr size_t lanes = 8;
+    const size_t m = query.length();
+    const size_t cap = k + 1;
+    std::vector<size_t> res (candidates.size(), cap);
+    std::vector<size_t> pending;
+    for (size_t i = 0; i < candidates.size(); i++) {
+        const size_t n = candidates[i].length();
+        if ((m > n ? m - n : n - m) > k) {
+            continue;
+        }
+        if (!m || m > 64) {
+            res[i] = BandedDistance(query, candidates[i], k);
+        } else {
+            pending.push_back(i);
+        }
+    }
+    if (pending.empty()) {
+        return res;
+    }
+
+    std::array<u64, 256> Peq {};
+    for (size_t i = 0; i < m; i++) {
+        Peq[static_cast<unsigned char>(query[i])] |= u64 {1} << i;
+    }
+    const u64 top = u64 {1} << (m - 1);
+    for (size_t g = 0; g < pending.size(); g += lanes) {
+        const size_t count = std::min(lanes, pending.size() - g);
+        std::array<const unsigned char*, lanes> text {};
+        std::array<size_t, lanes> len {};
+        std::array<u64, lanes> Pv, Mv, score;
+        size_t max_len = 0;
+        for (size_t l = 0; l < lanes; l++) {
+            Pv[l] = ~u64 {0};
+            Mv[l] = 0;
+            score[l] = m;
+            if (l < count) {
+                const auto& s = candidates[pending[g + l]];
+                text[l] = reinterpret_cast<const unsigned char*>(s.data());
+                len[l] = s.length();
+                max_len = std::max(max_len, len[l]);
+            }
+        }
+        for (size_t j = 0; j < max_len; j++) {
+            std::array<u64, lanes> Eq;
+            for (size_t l = 0; l < lanes; l++) {
+                Eq[l] = j < len[l] ? Peq[text[l][j]] : 0;
+            }
+            bool alive = false;
+            for (size_t l = 0; l < lanes; l++) {
+                const u64 active = j < len[l] ? ~u64 {0} : 0;
+                const u64 Xv = Eq[l] | Mv[l];
+                const u64 Xh = (((Eq[l] & Pv[l]) + Pv[l]) ^ Pv[l]) | Eq[l];
+                const u64 Ph = Mv[l] | ~(Xh | Pv[l]);
+                const u64 Mh = Pv[l] & Xh;
+                score[l] += (active & 1) & ((Ph & top) != 0);
+                score[l] -= (active & 1) & ((Mh & top) != 0);
+                const u64 Ph1 = (Ph << 1) | 1;
+                const u64 Mh1 = Mh << 1;
+                Pv[l] = (active & (Mh1 | ~(Xv | Ph1))) | (~active & Pv[l]);
+                Mv[l] = (active & (Ph1 & Xv)) | (~active & Mv[l]);
+                // the final distance is at least the current one minus the columns left
+                alive |= j + 1 < len[l] && score[l] <= k + (len[l] - j - 1);
+            }
+            if (!alive) {
+                break;
+            }
+        }
+        for (size_t l = 0; l < count; l++) {
+            res[pending[g + l]] = std::min<size_t>(score[l], cap);
+        }
+    }
+    return res;
+}
+
+int main() {
+    std::cout << LevenshteinDistance("algorithm", "altruistic") << ' '
+              << MyersDistance("algorithm", "altruistic") << ' '
+              << BandedDistance("algorithm", "altruistic", 6) << '\n';
+
+    std::mt19937 gen(std::random_device{}());
+    auto random_string = [&gen](size_t len, char hi) {
+        std::uniform_int_distribution<> dist('a', hi);
+        std::string s (len, ' ');
+        for (auto& c : s) {
+            c = static_cast<char>(dist(gen));
+        }
+        return s;
+    };
+    for (size_t iter = 0; iter < 500; iter++) {
+        const size_t max_len = iter % 2 ? 200 : 40;
+        auto x = random_string(gen() % max_len, 'd');
+        auto y = random_string(gen() % max_len, 'd');
+        const size_t d = LevenshteinDistance(x, y);
+        assert(MyersDistance(x, y) == d);
+        const size_t k = gen() % 50;
+        assert(BandedDistance(x, y, k) == std::min(d, k + 1));
+    }
+    for (size_t iter = 0; iter < 100; iter++) {
+        auto query = random_string(gen() % 70, 'c');
+        std::vector<std::string> candidates (gen() % 40);
+        for (auto& s : candidates) {
+            s = query;
+            for (size_t e = gen() % 6; e > 0; e--) {
+                const size_t pos = s.empty() ? 0 : gen() % s.length();
+                switch (gen() % 3) {
+                    case 0: s.insert(pos, 1, 'a'); break;
+                    case 1: if (!s.empty()) s.erase(pos, 1); break;
+                    default: if (!s.empty()) s[pos] = 'b'; break;
+                }
+            }
+        }
+        const size_t k = gen() % 5;
+        auto res = BatchDistance(query, candidates, k);
+        for (size_t i = 0; i < candidates.size(); i++) {
+            assert(res[i] == std::min(LevenshteinDistance(query, candidates[i]), k + 1));
+        }
+    }
+
+    // near-duplicate records against one query
+    auto query = random_string(40, 'z');
+    std::vector<std::string> records (1'000'000);
+    for (auto& s : records) {
+        s = gen() % 100 ? random_string(36 + gen() % 9, 'z') : query;
+        if (gen() % 2) {
+            s[gen() % s.length()] = 'a';
+        }
+    }
+    const size_t k = 3;
+    auto t1 = crn::steady_clock::now();
+    size_t full_dupes = 0;
+    for (const auto& s : records) {
+        full_dupes += LevenshteinDistance(query, s) <= k;
+    }
+    auto t2 = crn::steady_clock::now();
+    size_t myers_dupes = 0;
+    for (const auto& s : records) {
+        myers_dupes += MyersDistance(query, s) <= k;
+    }
+    auto t3 = crn::steady_clock::now();
+    size_t banded_dupes = 0;
+    for (const auto& s : records) {
+        banded_dupes += BandedDistance(query, s, k) <= k;
+    }
+    auto t4 = crn::steady_clock::now();
+    auto batch = BatchDistance(query, records, k);
+    auto t5 = crn::steady_clock::now();
+    const auto batch_dupes = static_cast<size_t>(std::count_if(batch.begin(), batch.end(), [k](size_t d) { return d <= k; }));
+    assert(full_dupes == myers_dupes && full_dupes == banded_dupes && full_dupes == batch_dupes);
+    std::cout << full_dupes << " records within distance " << k << '\n';
+    std::cout << "Full table : " << crn::duration_cast<crn::milliseconds>(t2 - t1).count() << "ms\n";
+    std::cout << "Myers : " << crn::duration_cast<crn::milliseconds>(t3 - t2).count() << "ms\n";
+    std::cout << "Banded : " << crn::duration_cast<crn::milliseconds>(t4 - t3).count() << "ms\n";
+    std::cout << "Batch : " << crn::duration_cast<crn::milliseconds>(t5 - t4).count() << "ms\n";
+}
@@ -0,0 +1,418 @@
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace crn = std::chrono;
+
+// dense hidden Markov model in log space. transitions are stored by destination, so the
+// max over source states of one destination reads a contiguous row, and emissions by symbol.
+class HMM {
+    size_t num_states = 0;
+    size_t num_symbols = 0;
+    std::vector<float> log_start; // [s]
+    std::vector<float> log_trans; // [to * S + from]
+    std::vector<float> log_emit; // [symbol * S + s]
+    std::vector<float> trans; // probabilities, [to * S + from]
+    std::vector<float> emit; // probabilities, [symbol * S + s]
+
+public:
+    // start[s], transition[from][to], emission[s][symbol]
+    HMM(const std::vector<double>& start, const std::vector<std::vector<double>>& transition,
+        const std::vector<std::vector<double>>& emission)
+        : num_states {start.size()}, num_symbols {emission.empty() ? 0 : emission[0].size()},
+          log_start (num_states), log_trans (num_states * num_states), log_emit (num_symbols * num_states),
+          trans (num_states * num_states), emit (num_symbols * num_states) {
+        assert(num_states && num_states <= 65536);
+        const size_t S = num_states;
+        for (size_t s = 0; s < S; s++) {
+            log_start[s] = static_cast<float>(std::log(start[s]));
+            for (size_t to = 0; to < S; to++) {
+                trans[to * S + s] = static_cast<float>(transition[s][to]);
+                log_trans[to * S + s] = static_cast<float>(std::log(transition[s][to]));
+            }
+            for (size_t o = 0; o < num_symbols; o++) {
+                emit[o * S + s] = static_cast<float>(emission[s][o]);
+                log_emit[o * S + s] = static_cast<float>(std::log(emission[s][o]));
+            }
+        }
+    }
+
+    [[nodiscard]] size_t NumStates() const {
+        return num_states;
+    }
+
+    [[nodiscard]] size_t NumSymbols() const {
+        return num_symbols;
+    }
+
+    [[nodiscard]] float LogStart(size_t s) const {
+        return log_start[s];
+    }
+
+    [[nodiscard]] const float* LogTransInto(size_t to) const {
+        return log_trans.data() + to * num_states;
+    }
+
+    [[nodiscard]] const float* LogEmit(size_t symbol) const {
+        return log_emit.data() + symbol * num_states;
+    }
+
+    [[nodiscard]] const float* TransInto(size_t to) const {
+        return trans.data() + to * num_states;
+    }
+
+    [[nodiscard]] const float* Emit(size_t symbol) const {
+        return emit.data() + symbol * num_states;
+    }
+};
+
+struct Decoding {
+    std::vector<std::uint32_t> path;
+    float log_prob = 0;
+};
+
+// single-sequence Viterbi in doubles, for checking
+Decoding Viterbi(const HMM& hmm, const std::vector<std::uint32_t>& obs) {
+    const size_t S = hmm.NumStates();
+    const size_t n = obs.size();
+    std::vector<std::vector<double>> V (n, std::vector<double>(S));
+    std::vector<std::vector<size_t>> back (n, std::vector<size_t>(S));
+    for (size_t s = 0; s < S; s++) {
+        V[0][s] = hmm.LogStart(s) + hmm.LogEmit(obs[0])[s];
+    }
+    for (size_t t = 1; t < n; t++) {
+        for (size_t s = 0; s < S; s++) {
+            double best = -std::numeric_limits<double>::infinity();
+            for (size_t from = 0; from < S; from++) {
+                double v = V[t - 1][from] + hmm.LogTransInto(s)[from];
+                if (v > best) {
+                    best = v;
+                    back[t][s] = from;
+                }
+            }
+            V[t][s] = best + hmm.LogEmit(obs[t])[s];
+        }
+    }
+    Decoding res;
+    size_t s = static_cast<size_t>(std::max_element(V[n - 1].begin(), V[n - 1].end()) - V[n - 1].begin());
+    res.log_prob = static_cast<float>(V[n - 1][s]);
+    res.path.resize(n);
+    for (size_t t = n; t-- > 0;) {
+        res.path[t] = static_cast<std::uint32_t>(s);
+        s = back[t][s];
+    }
+    return res;
+}
+
+// log probability of one given state path
+double PathLogProb(const HMM& hmm, const std::vector<std::uint32_t>& obs, const std::vector<std::uint32_t>& path) {
+    double res = hmm.LogStart(path[0]) + hmm.LogEmit(obs[0])[path[0]];
+    for (size_t t = 1; t < obs.size(); t++) {
+        res += hmm.LogTransInto(path[t])[path[t - 1]] + hmm.LogEmit(obs[t])[path[t]];
+    }
+    return res;
+}
+
+constexpr size_t lanes = 64;
+
+// decodes up to `lanes` sequences in lockstep. scores are kept state-major, lane-minor
+// (V[s * lanes + b]), so the max-plus product over source states runs down contiguous lanes
+// and vectorizes; back-pointers take one Ptr per state, lane and step.
+template <typename Ptr>
+void ViterbiLanes(const HMM& hmm, const std::vector<std::vector<std::uint32_t>>& obs, const size_t* ids, size_t count,
+                  std::vector<Decoding>& res) {
+    const size_t S = hmm.NumStates();
+    size_t max_len = 0;
+    std::array<size_t, lanes> len {};
+    for (size_t b = 0; b < count; b++) {
+        len[b] = obs[ids[b]].size();
+        max_len = std::max(max_len, len[b]);
+    }
+    std::vector<float> V (S * lanes);
+    std::vector<float> next (S * lanes);
+    std::vector<Ptr> back (max_len * S * lanes);
+    std::array<std::uint32_t, lanes> sym {};
+    std::array<float, lanes> best;
+    std::array<std::int32_t, lanes> arg; // as wide as the scores, and selected by masks, so the lane loop vectorizes
+    auto symbols_at = [&](size_t t) {
+        for (size_t b = 0; b < count; b++) {
+            sym[b] = t < len[b] ? obs[ids[b]][t] : 0;
+        }
+    };
+    auto finish = [&](size_t b, size_t t) { // lane b has read its last symbol at step t
+        size_t s = 0;
+        for (size_t q = 1; q < S; q++) {
+            if (V[q * lanes + b] > V[s * lanes + b]) {
+                s = q;
+            }
+        }
+        auto& out = res[ids[b]];
+        out.log_prob = V[s * lanes + b];
+        out.path.resize(t + 1);
+        for (size_t k = t + 1; k-- > 0;) {
+            out.path[k] = static_cast<std::uint32_t>(s);
+            s = back[(k * S + s) * lanes + b];
+        }
+    };
+
+    symbols_at(0);
+    for (size_t s = 0; s < S; s++) {
+        for (size_t b = 0; b < lanes; b++) {
+            V[s * lanes + b] = hmm.LogStart(s) + hmm.LogEmit(sym[b])[s];
+        }
+    }
+    for (size_t b = 0; b < count; b++) {
+        if (len[b] == 1) {
+            finish(b, 0);
+        }
+    }
+    for (size_t t = 1; t < max_len; t++) {
+        symbols_at(t);
+        for (size_t s = 0; s < S; s++) {
+            const float* tr = hmm.LogTransInto(s);
+            best.fill(-std::numeric_limits<float>::infinity());
+            arg.fill(0);
+            for (size_t from = 0; from < S; from++) {
+                const float w = tr[from];
+                const float* v = V.data() + from * lanes;
+                for (size_t b = 0; b < lanes; b++) {
+                    const float cand = v[b] + w;
+                    const std::int32_t better = -static_cast<std::int32_t>(cand > best[b]);
+                    best[b] = std::max(best[b], cand);
+                    arg[b] = (arg[b] & ~better) | (static_cast<std::int32_t>(from) & better);
+                }
+            }
+            const float* e = hmm.LogEmit(0) + s;
+            for (size_t b = 0; b < lanes; b++) {
+                next[s * lanes + b] = best[b] + e[sym[b] * S];
+            }
+            Ptr* out = back.data() + (t * S + s) * lanes;
+            for (size_t b = 0; b < lanes; b++) {
+                out[b] = static_cast<Ptr>(arg[b]);
+            }
+        }
+        std::swap(V, next);
+        for (size_t b = 0; b < count; b++) {
+            if (len[b] == t + 1) {
+                finish(b, t);
+            }
+        }
+    }
+}
+
+// sequences are sorted by length so each group of lanes has little padding, and groups are
+// spread over threads. back-pointers are uint8_t for up to 256 states, uint16_t beyond.
+std::vector<Decoding> BatchViterbi(const HMM& hmm, const std::vector<std::vector<std::uint32_t>>& obs,
+                                   size_t num_threads = std::thread::hardware_concurrency()) {
+    std::vector<Decoding> res (obs.size());
+    std::vector<size_t> order (obs.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&obs](size_t a, size_t b) { return obs[a].size() < obs[b].size(); });
+    for (const auto& o : obs) {
+        assert(!o.empty());
+    }
+    const size_t groups = (obs.size() + lanes - 1) / lanes;
+    num_threads = std::clamp<size_t>(num_threads, 1, std::max<size_t>(groups, 1));
+    auto worker = [&](size_t t) {
+        for (size_t g = t; g < groups; g += num_threads) {
+            const size_t count = std::min(lanes, obs.size() - g * lanes);
+            if (hmm.NumStates() <= 256) {
+                ViterbiLanes<std::uint8_t>(hmm, obs, order.data() + g * lanes, count, res);
+            } else {
+                ViterbiLanes<std::uint16_t>(hmm, obs, order.data() + g * lanes, count, res);
+            }
+        }
+    };
+    {
+        std::vector<std::jthread> threads;
+        for (size_t t = 1; t < num_threads; t++) {
+            threads.emplace_back(worker, t);
+        }
+        worker(0);
+    }
+    return res;
+}
+
+// forward algorithm over the same lane layout: log P(obs) per sequence. probabilities are
+// renormalized every step and the scale factors summed in log space, so the inner loop is a
+// plain multiply-add.
+std::vector<double> BatchForward(const HMM& hmm, const std::vector<std::vector<std::uint32_t>>& obs) {
+    const size_t S = hmm.NumStates();
+    std::vector<double> res (obs.size());
+    std::vector<float> A (S * lanes);
+    std::vector<float> next (S * lanes);
+    for (size_t g = 0; g < obs.size(); g += lanes) {
+        const size_t count = std::min(lanes, obs.size() - g);
+        size_t max_len = 0;
+        for (size_t b = 0; b < count; b++) {
+            max_len = std::max(max_len, obs[g + b].size());
+        }
+        std::array<double, lanes> log_scale {};
+        std::array<float, lanes> sum;
+        for (size_t t = 0; t < max_len; t++) {
+            std::array<std::uint32_t, lanes> sym {};
+            for (size_t b = 0; b < count; b++) {
+                sym[b] = t < obs[g + b].size() ? obs[g + b][t] : 0;
+            }
+            sum.fill(0);
+            for (size_t s = 0; s < S; s++) {
+                const float* e = hmm.Emit(0) + s;
+                std::array<float, lanes> acc {};
+                if (!t) {
+                    acc.fill(std::exp(hmm.LogStart(s)));
+                } else {
+                    const float* tr = hmm.TransInto(s);
+                    for (size_t from = 0; from < S; from++) {
+                        const float w = tr[from];
+                        const float* a = A.data() + from * lanes;
+                        for (size_t b = 0; b < lanes; b++) {
+                            acc[b] += a[b] * w;
+                        }
+                    }
+                }
+                for (size_t b = 0; b < lanes; b++) {
+                    next[s * lanes + b] = acc[b] * e[sym[b] * S];
+                    sum[b] += next[s * lanes + b];
+                }
+            }
+            for (size_t b = 0; b < count; b++) {
+                if (t < obs[g + b].size()) {
+                    log_scale[b] += std::log(static_cast<double>(sum[b]));
+                    const float inv = 1.0f / sum[b];
+                    for (size_t s = 0; s < S; s++) {
+                        next[s * lanes + b] *= inv;
+                    }
+                } else {
+                    for (size_t s = 0; s < S; s++) {
+                        next[s * lanes + b] = A[s * lanes + b];
+                    }
+                }
+            }
+            std::swap(A, next);
+        }
+        for (size_t b = 0; b < count; b++) {
+            res[g + b] = log_scale[b];
+        }
+    }
+    return res;
+}
+
+// log P(obs) by the forward algorithm in doubles, for checking
+double ForwardLogProb(const HMM& hmm, const std::vector<std::uint32_t>& obs) {
+    const size_t S = hmm.NumStates();
+    std::vector<double> a (S), next (S);
+    for (size_t s = 0; s < S; s++) {
+        a[s] = std::exp(static_cast<double>(hmm.LogStart(s) + hmm.LogEmit(obs[0])[s]));
+    }
+    double log_scale = 0;
+    for (size_t t = 0;; t++) {
+        double sum = std::accumulate(a.begin(), a.end(), 0.0);
+        log_scale += std::log(sum);
+        for (auto& x : a) {
+            x /= sum;
+        }
+        if (t + 1 == obs.size()) {
+            break;
+        }
+        for (size_t s = 0; s < S; s++) {
+            next[s] = 0;
+            for (size_t from = 0; from < S; from++) {
+                next[s] += a[from] * hmm.TransInto(s)[from];
+            }
+            next[s] *= hmm.Emit(obs[t + 1])[s];
+        }
+        std::swap(a, next);
+    }
+    return log_scale;
+}
+
+int main() {
+    // Healthy, Fever; normal, cold, dizzy
+    HMM example ({0.6, 0.4}, {{0.7, 0.3}, {0.4, 0.6}}, {{0.5, 0.4, 0.1}, {0.1, 0.3, 0.6}});
+    const std::vector<std::string> names {"Healthy", "Fever"};
+    auto decoded = BatchViterbi(example, {{0, 1, 2}});
+    std::cout << "The steps of the most probable state is: ";
+    for (auto s : decoded[0].path) {
+        std::cout << names[s] << ' ';
+    }
+    std::cout << '\n';
+
+    std::mt19937 gen(std::random_device{}());
+    std::uniform_real_distribution<> dist(0.05, 1.0);
+    auto random_model = [&](size_t S, size_t O) {
+        auto normalized = [&](size_t k) {
+            std::vector<double> v (k);
+            for (auto& x : v) {
+                x = dist(gen);
+            }
+            const double sum = std::accumulate(v.begin(), v.end(), 0.0);
+            for (auto& x : v) {
+                x /= sum;
+            }
+            return v;
+        };
+        std::vector<std::vector<double>> T (S), E (S);
+        for (size_t s = 0; s < S; s++) {
+            T[s] = normalized(S);
+            E[s] = normalized(O);
+        }
+        return HMM(normalized(S), T, E);
+    };
+    auto random_sequences = [&](size_t count, size_t max_len, size_t O) {
+        std::vector<std::vector<std::uint32_t>> obs (count);
+        for (auto& o : obs) {
+            o.resize(1 + gen() % max_len);
+            for (auto& x : o) {
+                x = static_cast<std::uint32_t>(gen() % O);
+            }
+        }
+        return obs;
+    };
+    for (size_t iter = 0; iter < 20; iter++) {
+        const size_t S = iter == 19 ? 300 : 1 + gen() % 20;
+        const size_t O = 1 + gen() % 30;
+        auto hmm = random_model(S, O);
+        auto obs = random_sequences(iter == 19 ? 5 : 1 + gen() % 200, 40, O);
+        auto batch = BatchViterbi(hmm, obs, 1 + gen() % 4);
+        auto forward = BatchForward(hmm, obs);
+        for (size_t i = 0; i < obs.size(); i++) {
+            auto single = Viterbi(hmm, obs[i]);
+            assert(batch[i].path.size() == obs[i].size());
+            assert(std::abs(batch[i].log_prob - single.log_prob) <= 1e-3f * std::max(1.0f, std::abs(single.log_prob)));
+            const double path_prob = PathLogProb(hmm, obs[i], batch[i].path);
+            assert(std::abs(path_prob - single.log_prob) <= 1e-3 * std::max(1.0, std::abs(path_prob)));
+            const double expected = ForwardLogProb(hmm, obs[i]);
+            assert(std::abs(forward[i] - expected) <= 1e-3 * std::max(1.0, std::abs(expected)));
+            assert(forward[i] >= batch[i].log_prob - 1e-3 * std::abs(expected));
+        }
+    }
+
+    // tagging workload: 100k sentences, 16 tags, 500 word classes
+    auto hmm = random_model(16, 500);
+    auto obs = random_sequences(100'000, 40, 500);
+    auto t1 = crn::steady_clock::now();
+    for (size_t i = 0; i < 2'000; i++) {
+        Viterbi(hmm, obs[i]);
+    }
+    auto t2 = crn::steady_clock::now();
+    auto batch = BatchViterbi(hmm, obs);
+    auto t3 = crn::steady_clock::now();
+    auto forward = BatchForward(hmm, obs);
+    auto t4 = crn::steady_clock::now();
+    const double single_rate = 2'000.0 / crn::duration<double>(t2 - t1).count();
+    const double batch_rate = static_cast<double>(obs.size()) / crn::duration<double>(t3 - t2).count();
+    const double forward_rate = static_cast<double>(obs.size()) / crn::duration<double>(t4 - t3).count();
+    std::cout << "Viterbi, one sequence at a time : " << static_cast<size_t>(single_rate) << " sequences/s\n";
+    std::cout << "Batched Viterbi : " << static_cast<size_t>(batch_rate) << " sequences/s\n";
+    std::cout << "Batched forward : " << static_cast<size_t>(forward_rate) << " sequences/s\n";
+}
@@ -0,0 +1,427 @@
+#include <algorithm>
+#include <barrier>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace crn = std::chrono;
+
+using Seam = std::vector<std::uint32_t>; // column of the seam in every row
+
+// the kernels below run fixed-length inner loops over planes that never alias, in 16-bit
+// luminance and energy and 32-bit cost, so gcc vectorizes them at -O2
+constexpr size_t block = 16;
+
+// interior columns [lo, hi) of an energy row. |a - b| is max - min
+void EnergyKernel(const std::int16_t* __restrict L, const std::int16_t* __restrict U, const std::int16_t* __restrict D,
+                  std::int16_t* __restrict E, size_t lo, size_t hi) {
+    size_t j = lo;
+    for (; j + block <= hi; j += block) {
+        for (size_t k = 0; k < block; k++) {
+            const std::int16_t l = L[j + k - 1];
+            const std::int16_t r = L[j + k + 1];
+            const std::int16_t dx = std::max(l, r) - std::min(l, r);
+            const std::int16_t dy = std::max(U[j + k], D[j + k]) - std::min(U[j + k], D[j + k]);
+            E[j + k] = dx + dy;
+        }
+    }
+    for (; j < hi; j++) {
+        E[j] = static_cast<std::int16_t>(std::abs(L[j + 1] - L[j - 1]) + std::abs(D[j] - U[j]));
+    }
+}
+
+// interior columns [lo, hi) of a cost row
+void CostKernel(const std::int16_t* __restrict E, const std::int32_t* __restrict prev, std::int32_t* __restrict cur,
+                size_t lo, size_t hi) {
+    size_t j = lo;
+    for (; j + block <= hi; j += block) {
+        for (size_t k = 0; k < block; k++) {
+            cur[j + k] = E[j + k] + std::min(std::min(prev[j + k - 1], prev[j + k]), prev[j + k + 1]);
+        }
+    }
+    for (; j < hi; j++) {
+        cur[j] = E[j] + std::min(std::min(prev[j - 1], prev[j]), prev[j + 1]);
+    }
+}
+
+class SeamCarver {
+    size_t width = 0;
+    size_t height = 0;
+    size_t stride = 0;
+    std::vector<std::uint32_t> pixels;
+    std::vector<std::int16_t> luma;
+    std::vector<std::int16_t> energy;
+    std::vector<std::int32_t> cost; // cumulative minimum seam cost
+
+    // energy of row i, columns [c0, c1)
+    void EnergyRow(size_t i, size_t c0, size_t c1) {
+        const std::int16_t* L = luma.data() + i * stride;
+        const std::int16_t* U = luma.data() + (i ? i - 1 : 0) * stride;
+        const std::int16_t* D = luma.data() + (i + 1 < height ? i + 1 : i) * stride;
+        std::int16_t* E = energy.data() + i * stride;
+        auto border = [&](size_t j) {
+            const int left = L[j ? j - 1 : 0];
+            const int right = L[j + 1 < width ? j + 1 : j];
+            E[j] = static_cast<std::int16_t>(std::abs(right - left) + std::abs(D[j] - U[j]));
+        };
+        if (c0 == 0 && c0 < c1) {
+            border(0);
+        }
+        const size_t lo = std::max<size_t>(c0, 1);
+        const size_t hi = std::min(c1, width - 1);
+        if (lo < hi) {
+            EnergyKernel(L, U, D, E, lo, hi);
+        }
+        if (c1 == width && width > 1) {
+            border(width - 1);
+        }
+    }
+
+    // cost row i, columns [c0, c1), from cost row i - 1 in prev (indexed by column)
+    void CostRow(size_t i, const std::int32_t* prev, std::int32_t* cur, size_t c0, size_t c1) const {
+        const std::int16_t* E = energy.data() + i * stride;
+        auto border = [&](size_t j) {
+            const std::int32_t l = prev[j ? j - 1 : 0];
+            const std::int32_t r = prev[j + 1 < width ? j + 1 : j];
+            cur[j] = E[j] + std::min({l, prev[j], r});
+        };
+        if (c0 == 0 && c0 < c1) {
+            border(0);
+        }
+        const size_t lo = std::max<size_t>(c0, 1);
+        const size_t hi = std::min(c1, width - 1);
+        if (lo < hi) {
+            CostKernel(E, prev, cur, lo, hi);
+        }
+        if (c1 == width && width > 1) {
+            border(width - 1);
+        }
+    }
+
+    void ComputeCostSerial() {
+        std::copy_n(energy.begin(), width, cost.begin());
+        for (size_t i = 1; i < height; i++) {
+            CostRow(i, cost.data() + (i - 1) * stride, cost.data() + i * stride, 0, width);
+        }
+    }
+
+    // row bands of `band` rows. every thread owns a strip of columns and also computes a halo
+    // that shrinks by one column per row, so a band needs no synchronization until its end.
+    void ComputeCostParallel(size_t num_threads, size_t band = 32) {
+        std::copy_n(energy.begin(), width, cost.begin());
+        const size_t strip = (width + num_threads - 1) / num_threads;
+        std::barrier sync (static_cast<std::ptrdiff_t>(num_threads));
+        auto worker = [&](size_t t) {
+            const size_t c0 = std::min(width, t * strip);
+            const size_t c1 = std::min(width, c0 + strip);
+            const size_t lo = c0 > band ? c0 - band : 0;
+            const size_t hi = std::min(width, c1 + band);
+            std::vector<std::int32_t> prev (width), cur (width);
+            for (size_t r0 = 1; r0 < height; r0 += band) {
+                std::copy(cost.begin() + static_cast<std::ptrdiff_t>((r0 - 1) * stride + lo),
+                          cost.begin() + static_cast<std::ptrdiff_t>((r0 - 1) * stride + hi), prev.begin() + static_cast<std::ptrdiff_t>(lo));
+                for (size_t r = r0; r < std::min(height, r0 + band); r++) {
+                    const size_t shrink = r - r0 + 1;
+                    const size_t a = lo ? lo + shrink : 0;
+                    const size_t b = hi < width ? hi - shrink : width;
+                    CostRow(r, prev.data(), cur.data(), a, b);
+                    std::copy(cur.begin() + static_cast<std::ptrdiff_t>(c0), cur.begin() + static_cast<std::ptrdiff_t>(c1),
+                              cost.begin() + static_cast<std::ptrdiff_t>(r * stride + c0));
+                    std::swap(prev, cur);
+                }
+                sync.arrive_and_wait();
+            }
+        };
+        std::vector<std::jthread> threads;
+        for (size_t t = 1; t < num_threads; t++) {
+            threads.emplace_back(worker, t);
+        }
+        worker(0);
+    }
+
+    void ComputeCost(size_t num_threads) {
+        // a strip narrower than its halo would do more redundant work than useful work
+        num_threads = std::clamp<size_t>(num_threads, 1, std::max<size_t>(width / 256, 1));
+        if (num_threads == 1) {
+            ComputeCostSerial();
+        } else {
+            ComputeCostParallel(num_threads);
+        }
+    }
+
+    [[nodiscard]] Seam TraceBack(size_t end) const {
+        Seam seam (height);
+        size_t j = end;
+        for (size_t i = height; i-- > 0;) {
+            seam[i] = static_cast<std::uint32_t>(j);
+            if (i) {
+                const std::int32_t* prev = cost.data() + (i - 1) * stride;
+                size_t best = j;
+                if (j && prev[j - 1] <= prev[best]) {
+                    best = j - 1;
+                }
+                if (j + 1 < width && prev[j + 1] < prev[best]) {
+                    best = j + 1;
+                }
+                j = best;
+            }
+        }
+        return seam;
+    }
+
+    template <typename T>
+    void RemoveFromRow(std::vector<T>& plane, size_t i, size_t j) {
+        T* row = plane.data() + i * stride;
+        std::memmove(row + j, row + j + 1, (width - j - 1) * sizeof(T));
+    }
+
+public:
+    SeamCarver(std::vector<std::uint32_t> image, size_t w, size_t h)
+        : width {w}, height {h}, stride {w}, pixels {std::move(image)}, luma (w * h), energy (w * h), cost (w * h) {
+        assert(pixels.size() == w * h && w && h && h < (size_t {1} << 22)); // costs fit in 32 bits
+        for (size_t k = 0; k < pixels.size(); k++) {
+            const std::uint32_t p = pixels[k];
+            luma[k] = static_cast<std::int16_t>((77 * (p >> 16 & 0xFF) + 150 * (p >> 8 & 0xFF) + 29 * (p & 0xFF)) >> 8);
+        }
+        ComputeEnergy();
+    }
+
+    void ComputeEnergy() {
+        for (size_t i = 0; i < height; i++) {
+            EnergyRow(i, 0, width);
+        }
+    }
+
+    [[nodiscard]] size_t Width() const {
+        return width;
+    }
+
+    [[nodiscard]] size_t Height() const {
+        return height;
+    }
+
+    [[nodiscard]] std::int16_t Energy(size_t i, size_t j) const {
+        return energy[i * stride + j];
+    }
+
+    [[nodiscard]] std::uint32_t Pixel(size_t i, size_t j) const {
+        return pixels[i * stride + j];
+    }
+
+    [[nodiscard]] std::uint64_t SeamCost(const Seam& seam) const {
+        std::uint64_t res = 0;
+        for (size_t i = 0; i < height; i++) {
+            res += energy[i * stride + seam[i]];
+        }
+        return res;
+    }
+
+    [[nodiscard]] Seam FindSeam(size_t num_threads = 1) {
+        ComputeCost(num_threads);
+        const std::int32_t* last = cost.data() + (height - 1) * stride;
+        return TraceBack(static_cast<size_t>(std::min_element(last, last + width) - last));
+    }
+
+    // up to k pixel-disjoint seams from one cost table: bottom cells in increasing cost order
+    // are traced back, and a trace that runs into an earlier seam is dropped. approximates k
+    // rounds of FindSeam and RemoveSeam at the cost of one.
+    [[nodiscard]] std::vector<Seam> FindSeams(size_t k, size_t num_threads = 1) {
+        ComputeCost(num_threads);
+        const std::int32_t* last = cost.data() + (height - 1) * stride;
+        std::vector<std::uint32_t> ends (width);
+        std::iota(ends.begin(), ends.end(), 0);
+        std::sort(ends.begin(), ends.end(), [last](std::uint32_t a, std::uint32_t b) { return last[a] < last[b]; });
+        std::vector<std::uint8_t> used (height * width);
+        std::vector<Seam> res;
+        for (size_t e = 0; e < ends.size() && res.size() < k; e++) {
+            auto seam = TraceBack(ends[e]);
+            bool free = true;
+            for (size_t i = 0; i < height && free; i++) {
+                free = !used[i * width + seam[i]];
+            }
+            if (!free) {
+                continue;
+            }
+            for (size_t i = 0; i < height; i++) {
+                used[i * width + seam[i]] = 1;
+            }
+            res.push_back(std::move(seam));
+        }
+        return res;
+    }
+
+    // removes one seam, then recomputes energy only where a neighbour changed: in row i, the
+    // columns between the seam's positions in rows i - 1, i and i + 1, widened by one
+    void RemoveSeam(const Seam& seam) {
+        assert(seam.size() == height && width > 1);
+        for (size_t i = 0; i < height; i++) {
+            RemoveFromRow(pixels, i, seam[i]);
+            RemoveFromRow(luma, i, seam[i]);
+            RemoveFromRow(energy, i, seam[i]);
+        }
+        width--;
+        for (size_t i = 0; i < height; i++) {
+            const size_t up = seam[i ? i - 1 : 0];
+            const size_t down = seam[i + 1 < height ? i + 1 : i];
+            const size_t lo = std::min({up, size_t {seam[i]}, down});
+            const size_t hi = std::max({up, size_t {seam[i]}, down});
+            EnergyRow(i, lo ? lo - 1 : 0, std::min(width, hi + 1));
+        }
+    }
+
+    // removes pixel-disjoint seams in one compaction pass per row, then recomputes all energy
+    void RemoveSeams(const std::vector<Seam>& seams) {
+        assert(seams.size() < width);
+        std::vector<std::uint32_t> cols (seams.size());
+        for (size_t i = 0; i < height; i++) {
+            for (size_t s = 0; s < seams.size(); s++) {
+                cols[s] = seams[s][i];
+            }
+            std::sort(cols.begin(), cols.end());
+            std::uint32_t* P = pixels.data() + i * stride;
+            std::int16_t* L = luma.data() + i * stride;
+            size_t out = 0;
+            size_t next = 0;
+            for (size_t j = 0; j < width; j++) {
+                if (next < cols.size() && cols[next] == j) {
+                    next++;
+                    continue;
+                }
+                P[out] = P[j];
+                L[out] = L[j];
+                out++;
+            }
+        }
+        width -= seams.size();
+        ComputeEnergy();
+    }
+
+    // removes `columns` columns, seams_per_pass seams per cost table
+    void Carve(size_t columns, size_t seams_per_pass = 1, size_t num_threads = 1) {
+        assert(columns < width && seams_per_pass);
+        while (columns) {
+            if (seams_per_pass == 1) {
+                RemoveSeam(FindSeam(num_threads));
+                columns--;
+            } else {
+                auto seams = FindSeams(std::min(columns, seams_per_pass), num_threads);
+                columns -= seams.size();
+                RemoveSeams(seams);
+            }
+        }
+    }
+};
+
+// minimum seam cost over a plain table, for checking
+std::uint64_t MinimumSeamCost(const SeamCarver& carver) {
+    const size_t m = carver.Height();
+    const size_t n = carver.Width();
+    std::vector<std::uint64_t> D (n), next (n);
+    for (size_t j = 0; j < n; j++) {
+        D[j] = carver.Energy(0, j);
+    }
+    for (size_t i = 1; i < m; i++) {
+        for (size_t j = 0; j < n; j++) {
+            std::uint64_t best = D[j];
+            if (j) {
+                best = std::min(best, D[j - 1]);
+            }
+            if (j + 1 < n) {
+                best = std::min(best, D[j + 1]);
+            }
+            next[j] = best + carver.Energy(i, j);
+        }
+        std::swap(D, next);
+    }
+    return *std::min_element(D.begin(), D.end());
+}
+
+int main() {
+    std::mt19937 gen(std::random_device{}());
+    auto random_image = [&gen](size_t w, size_t h) {
+        std::vector<std::uint32_t> image (w * h);
+        for (size_t i = 0; i < h; i++) {
+            for (size_t j = 0; j < w; j++) {
+                // smooth background with noisy objects
+                const auto base = static_cast<std::uint32_t>((i * 255 / h) << 16 | (j * 255 / w) << 8 | 128);
+                image[i * w + j] = gen() % 8 ? base : static_cast<std::uint32_t>(gen() & 0xFFFFFF);
+            }
+        }
+        return image;
+    };
+    auto is_seam = [](const Seam& seam, size_t w) {
+        for (size_t i = 0; i < seam.size(); i++) {
+            if (seam[i] >= w || (i && (seam[i] + 1 < seam[i - 1] || seam[i] > seam[i - 1] + 1))) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    for (size_t iter = 0; iter < 50; iter++) {
+        const size_t w = 2 + gen() % 600;
+        const size_t h = 1 + gen() % 80;
+        SeamCarver carver (random_image(w, h), w, h);
+        for (size_t round = 0; round < std::min<size_t>(w - 1, 10); round++) {
+            auto seam = carver.FindSeam(1);
+            assert(is_seam(seam, carver.Width()));
+            assert(carver.SeamCost(seam) == MinimumSeamCost(carver));
+            auto parallel = carver.FindSeam(1 + gen() % 4);
+            assert(carver.SeamCost(parallel) == carver.SeamCost(seam));
+            carver.RemoveSeam(seam);
+            // the incremental update must agree with recomputing every pixel
+            std::vector<std::int16_t> incremental;
+            for (size_t i = 0; i < carver.Height(); i++) {
+                for (size_t j = 0; j < carver.Width(); j++) {
+                    incremental.push_back(carver.Energy(i, j));
+                }
+            }
+            carver.ComputeEnergy();
+            for (size_t i = 0, k = 0; i < carver.Height(); i++) {
+                for (size_t j = 0; j < carver.Width(); j++, k++) {
+                    assert(incremental[k] == carver.Energy(i, j));
+                }
+            }
+        }
+        if (carver.Width() > 8) {
+            auto seams = carver.FindSeams(4);
+            for (const auto& s : seams) {
+                assert(is_seam(s, carver.Width()));
+            }
+            const size_t before = carver.Width();
+            carver.RemoveSeams(seams);
+            assert(carver.Width() == before - seams.size());
+        }
+    }
+
+    // 4K frame narrowed by 200 columns
+    const size_t w = 3840, h = 2160, columns = 200;
+    auto image = random_image(w, h);
+    const size_t threads = std::max(4u, std::thread::hardware_concurrency());
+    auto bench = [&](const std::string& name, auto&& carve) {
+        SeamCarver carver (image, w, h);
+        auto t1 = crn::steady_clock::now();
+        carve(carver);
+        auto t2 = crn::steady_clock::now();
+        assert(carver.Width() == w - columns);
+        std::cout << name << " : " << crn::duration_cast<crn::milliseconds>(t2 - t1).count() << "ms\n";
+    };
+    bench("Full energy recomputed per seam", [&](SeamCarver& c) {
+        for (size_t k = 0; k < columns; k++) {
+            auto seam = c.FindSeam();
+            c.RemoveSeam(seam);
+            c.ComputeEnergy();
+        }
+    });
+    bench("Incremental energy", [&](SeamCarver& c) { c.Carve(columns); });
+    bench("Incremental energy, banded DP on " + std::to_string(threads) + " threads", [&](SeamCarver& c) { c.Carve(columns, 1, threads); });
+    bench("20 seams per pass", [&](SeamCarver& c) { c.Carve(columns, 20); });
+}
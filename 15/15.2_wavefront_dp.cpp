@@ -0,0 +1,510 @@
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <ranges>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace crn = std::chrono;
+namespace sr = std::ranges;
+
+// serial versions from 15.2, 15.5, 15-2 and 15.4, for checking
+
+std::pair<std::vector<std::vector<size_t>>, std::vector<std::vector<size_t>>> MatrixChainOrder(const std::vector<size_t>& p) {
+    assert(p.size() > 1);
+    size_t n = p.size() - 1;
+    std::vector<std::vector<size_t>> m (n, std::vector<size_t>(n));
+    std::vector<std::vector<size_t>> s (n, std::vector<size_t>(n));
+    for (size_t l = 2; l <= n; l++) {
+        for (size_t i = 0; i < n - l + 1; i++) {
+            size_t j = i + l - 1;
+            m[i][j] = std::numeric_limits<size_t>::max();
+            for (size_t k = i; k < j; k++) {
+                auto q = m[i][k] + m[k + 1][j] + p[i] * p[k + 1] * p[j + 1];
+                if (q < m[i][j]) {
+                    m[i][j] = q;
+                    s[i][j] = k;
+                }
+            }
+        }
+    }
+    return {m, s};
+}
+
+// keys p[1 .. n] (p[0] unused), dummy keys q[0 .. n]
+std::pair<std::vector<std::vector<double>>, std::vector<std::vector<size_t>>>
+OptimalBST(const std::vector<double>& p, const std::vector<double>& q) {
+    assert(!p.empty() && q.size() == p.size());
+    size_t n = p.size() - 1;
+    std::vector<std::vector<double>> expect (n + 2, std::vector<double>(n + 1));
+    std::vector<std::vector<double>> partialProbSum (n + 2, std::vector<double>(n + 1));
+    std::vector<std::vector<size_t>> root (n + 1, std::vector<size_t>(n + 1));
+    for (size_t i = 1; i <= n + 1; i++) {
+        expect[i][i - 1] = q[i - 1];
+        partialProbSum[i][i - 1] = q[i - 1];
+    }
+    for (size_t l = 1; l <= n; l++) { // l : length of chain
+        for (size_t i = 1; i <= n - l + 1; i++) { // begin
+            size_t j = i + l - 1; // end
+            expect[i][j] = std::numeric_limits<double>::max();
+            partialProbSum[i][j] = partialProbSum[i][j - 1] + p[j] + q[j];
+            for (size_t r = i; r <= j; r++) { // root
+                double v = expect[i][r - 1] + expect[r + 1][j] + partialProbSum[i][j];
+                if (v < expect[i][j]) {
+                    expect[i][j] = v;
+                    root[i][j] = r;
+                }
+            }
+        }
+    }
+    return {expect, root};
+}
+
+enum class Dir {
+    upleft,
+    up,
+    left,
+    upright,
+    right,
+};
+
+std::string LongestPalindromicSubsequence(const std::string& str) {
+    std::vector<std::vector<size_t>> len (str.length(), std::vector<size_t>(str.length()));
+    for (size_t i = 0; i < str.length(); i++) {
+        len[i][i] = 1;
+    }
+
+    std::vector<std::vector<Dir>> B (str.length(), std::vector<Dir>(str.length(), Dir::upright));
+
+    for (size_t l = 2; l <= str.length(); l++) {
+        for (size_t i = 0; i < str.length() - l + 1; i++) {
+            size_t j = i + l - 1;
+            if (str[i] == str[j]) {
+                len[i][j] = len[i + 1][j - 1]  + 2;
+                B[i][j] = Dir::upright;
+            } else if (len[i][j - 1] > len[i + 1][j]) {
+                len[i][j] = len[i][j - 1];
+                B[i][j] = Dir::up;
+            } else {
+                len[i][j] = len[i + 1][j];
+                B[i][j] = Dir::right;
+            }
+        }
+    }
+    size_t i = 0, j = str.length() - 1;
+    std::string result;
+    bool centered = false;
+    while (len[i][j]) {
+        if (len[i][j] == 1) { // any single character, not only i == j
+            centered = true;
+            break;
+        }
+        if (B[i][j] == Dir::upright) {
+            result += str[i];
+            i++;
+            j--;
+        } else if (B[i][j] == Dir::up) {
+            j--;
+        } else {
+            i++;
+        }
+    }
+    auto rev = result;
+    sr::reverse(rev);
+    if (centered) {
+        result = result + str[i] + rev;
+    } else {
+        result = result + rev;
+    }
+    return result;
+}
+
+template <typename T>
+std::pair<std::vector<std::vector<size_t>>, std::vector<std::vector<Dir>>>
+LCSLength(const std::vector<T>& X, const std::vector<T>& Y) {
+    std::vector<std::vector<Dir>> B (X.size(), std::vector<Dir>(Y.size(), Dir::upleft));
+    std::vector<std::vector<size_t>> C (X.size() + 1, std::vector<size_t>(Y.size() + 1));
+    for (size_t i = 0; i < X.size(); i++) {
+        for (size_t j = 0; j < Y.size(); j++) {
+            if (X[i] == Y[j]) {
+                C[i + 1][j + 1] = C[i][j] + 1;
+                B[i][j] = Dir::upleft;
+            } else if (C[i][j + 1] >= C[i + 1][j]) {
+                C[i + 1][j + 1] = C[i][j + 1];
+                B[i][j] = Dir::up;
+            } else {
+                C[i + 1][j + 1] = C[i + 1][j];
+                B[i][j] = Dir::left;
+            }
+        }
+    }
+    return {C, B};
+}
+
+// row-major table in one contiguous buffer
+template <typename T>
+class Table {
+    size_t num_rows = 0;
+    size_t num_cols = 0;
+    std::vector<T> data;
+
+public:
+    Table(size_t rows, size_t cols, T value = T {}) : num_rows {rows}, num_cols {cols}, data (rows * cols, value) {}
+
+    T& operator()(size_t i, size_t j) {
+        return data[i * num_cols + j];
+    }
+
+    const T& operator()(size_t i, size_t j) const {
+        return data[i * num_cols + j];
+    }
+
+    [[nodiscard]] const T* Row(size_t i) const {
+        return data.data() + i * num_cols;
+    }
+
+    [[nodiscard]] size_t Rows() const {
+        return num_rows;
+    }
+
+    [[nodiscard]] size_t Cols() const {
+        return num_cols;
+    }
+};
+
+// runs run(w, t) for every tile t < tiles(w) of every wave w = 0, 1, ..., num_waves - 1.
+// tiles of one wave are claimed from an atomic counter by all threads, and a barrier
+// separates consecutive waves.
+template <typename Count, typename Run>
+void RunWaves(size_t num_waves, Count&& tiles, Run&& run, size_t num_threads) {
+    num_threads = std::max<size_t>(num_threads, 1);
+    if (num_threads == 1) {
+        for (size_t w = 0; w < num_waves; w++) {
+            for (size_t t = 0; t < tiles(w); t++) {
+                run(w, t);
+            }
+        }
+        return;
+    }
+    std::atomic<size_t> next {0};
+    size_t wave = 0;
+    std::barrier sync (static_cast<std::ptrdiff_t>(num_threads), [&]() noexcept {
+        wave++;
+        next = 0;
+    });
+    auto worker = [&]() {
+        while (wave < num_waves) {
+            const size_t w = wave;
+            const size_t count = tiles(w);
+            for (size_t t = next++; t < count; t = next++) {
+                run(w, t);
+            }
+            sync.arrive_and_wait();
+        }
+    };
+    std::vector<std::jthread> threads;
+    for (size_t t = 1; t < num_threads; t++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+}
+
+// interval DPs: cell(i, j) for 0 <= i <= j < n may read any (i, k) with k < j and (k, j) with
+// k > i. tiles (I, I + d) of one tile diagonal d depend only on smaller diagonals, and inside
+// a tile rows go bottom-up, columns left to right.
+template <typename Cell>
+void IntervalWavefront(size_t n, Cell&& cell, size_t num_threads = std::thread::hardware_concurrency(),
+                       size_t tile = 64) {
+    const size_t T = (n + tile - 1) / tile;
+    RunWaves(T, [T](size_t d) { return T - d; }, [&](size_t d, size_t t) {
+        const size_t I = t;
+        const size_t J = t + d;
+        const size_t row_lo = I * tile;
+        const size_t row_hi = std::min(n, row_lo + tile);
+        const size_t col_lo = J * tile;
+        const size_t col_hi = std::min(n, col_lo + tile);
+        for (size_t i = row_hi; i-- > row_lo;) {
+            for (size_t j = std::max(i, col_lo); j < col_hi; j++) {
+                cell(i, j);
+            }
+        }
+    }, num_threads);
+}
+
+// grid DPs: cell(i, j) for i < rows, j < cols may read (i - 1, j), (i, j - 1) and (i - 1, j - 1).
+// tiles run along anti-diagonals, row-major inside a tile.
+template <typename Cell>
+void GridWavefront(size_t rows, size_t cols, Cell&& cell, size_t num_threads = std::thread::hardware_concurrency(),
+                   size_t tile = 256) {
+    const size_t TR = (rows + tile - 1) / tile;
+    const size_t TC = (cols + tile - 1) / tile;
+    if (!TR || !TC) {
+        return;
+    }
+    auto first_row = [TC](size_t w) { return w >= TC ? w - TC + 1 : 0; };
+    RunWaves(TR + TC - 1, [&](size_t w) { return std::min(w, TR - 1) + 1 - first_row(w); }, [&](size_t w, size_t t) {
+        const size_t I = first_row(w) + t;
+        const size_t J = w - I;
+        for (size_t i = I * tile; i < std::min(rows, (I + 1) * tile); i++) {
+            for (size_t j = J * tile; j < std::min(cols, (J + 1) * tile); j++) {
+                cell(i, j);
+            }
+        }
+    }, num_threads);
+}
+
+// m(k + 1, j) is read down a column, so a transposed copy mt(j, k + 1) keeps the inner loop
+// on two contiguous rows
+std::pair<Table<size_t>, Table<size_t>> ParallelMatrixChainOrder(const std::vector<size_t>& p,
+        size_t num_threads = std::thread::hardware_concurrency()) {
+    assert(p.size() > 1);
+    const size_t n = p.size() - 1;
+    Table<size_t> m (n, n);
+    Table<size_t> mt (n, n);
+    Table<size_t> s (n, n);
+    IntervalWavefront(n, [&](size_t i, size_t j) {
+        if (i == j) {
+            return;
+        }
+        const size_t* left = m.Row(i);
+        const size_t* below = mt.Row(j);
+        size_t best = std::numeric_limits<size_t>::max();
+        size_t split = i;
+        for (size_t k = i; k < j; k++) {
+            auto q = left[k] + below[k + 1] + p[i] * p[k + 1] * p[j + 1];
+            if (q < best) {
+                best = q;
+                split = k;
+            }
+        }
+        m(i, j) = best;
+        mt(j, i) = best;
+        s(i, j) = split;
+    }, num_threads);
+    return {m, s};
+}
+
+void PrintOptimalParens(const Table<size_t>& s, size_t i, size_t j) {
+    if (i == j) {
+        std::cout << "A_" << i;
+    } else {
+        std::cout << '(';
+        PrintOptimalParens(s, i, s(i, j));
+        PrintOptimalParens(s, s(i, j) + 1, j);
+        std::cout << ')';
+    }
+}
+
+// cell (i, j) of the executor is the key range [i + 1, j + 1]
+std::pair<Table<double>, Table<size_t>> ParallelOptimalBST(const std::vector<double>& p, const std::vector<double>& q,
+        size_t num_threads = std::thread::hardware_concurrency()) {
+    assert(!p.empty() && q.size() == p.size());
+    const size_t n = p.size() - 1;
+    Table<double> expect (n + 2, n + 1);
+    Table<double> expect_t (n + 1, n + 2); // expect_t(j, i) = expect(i, j)
+    Table<double> partialProbSum (n + 2, n + 1);
+    Table<size_t> root (n + 1, n + 1);
+    for (size_t i = 1; i <= n + 1; i++) {
+        expect(i, i - 1) = q[i - 1];
+        expect_t(i - 1, i) = q[i - 1];
+        partialProbSum(i, i - 1) = q[i - 1];
+    }
+    IntervalWavefront(n, [&](size_t a, size_t b) {
+        const size_t i = a + 1;
+        const size_t j = b + 1;
+        const double w = partialProbSum(i, j - 1) + p[j] + q[j];
+        partialProbSum(i, j) = w;
+        const double* left = expect.Row(i);
+        const double* below = expect_t.Row(j);
+        double best = std::numeric_limits<double>::max();
+        size_t best_root = i;
+        for (size_t r = i; r <= j; r++) {
+            double v = left[r - 1] + below[r + 1] + w;
+            if (v < best) {
+                best = v;
+                best_root = r;
+            }
+        }
+        expect(i, j) = best;
+        expect_t(j, i) = best;
+        root(i, j) = best_root;
+    }, num_threads);
+    return {expect, root};
+}
+
+std::string ParallelLongestPalindromicSubsequence(const std::string& str,
+        size_t num_threads = std::thread::hardware_concurrency()) {
+    const size_t n = str.length();
+    if (!n) {
+        return {};
+    }
+    Table<size_t> len (n, n);
+    Table<Dir> B (n, n, Dir::upright);
+    IntervalWavefront(n, [&](size_t i, size_t j) {
+        if (i == j) {
+            len(i, j) = 1;
+        } else if (str[i] == str[j]) {
+            len(i, j) = (i + 1 <= j - 1 ? len(i + 1, j - 1) : 0) + 2;
+            B(i, j) = Dir::upright;
+        } else if (len(i, j - 1) > len(i + 1, j)) {
+            len(i, j) = len(i, j - 1);
+            B(i, j) = Dir::up;
+        } else {
+            len(i, j) = len(i + 1, j);
+            B(i, j) = Dir::right;
+        }
+    }, num_threads);
+    size_t i = 0, j = n - 1;
+    std::string result;
+    bool centered = false;
+    while (i <= j && len(i, j)) {
+        if (len(i, j) == 1) {
+            centered = true;
+            break;
+        }
+        if (B(i, j) == Dir::upright) {
+            result += str[i];
+            i++;
+            j--;
+        } else if (B(i, j) == Dir::up) {
+            j--;
+        } else {
+            i++;
+        }
+    }
+    auto rev = result;
+    sr::reverse(rev);
+    return centered ? result + str[i] + rev : result + rev;
+}
+
+template <typename T>
+std::pair<Table<size_t>, Table<Dir>> ParallelLCSLength(const std::vector<T>& X, const std::vector<T>& Y,
+        size_t num_threads = std::thread::hardware_concurrency()) {
+    Table<Dir> B (X.size(), Y.size(), Dir::upleft);
+    Table<size_t> C (X.size() + 1, Y.size() + 1);
+    GridWavefront(X.size(), Y.size(), [&](size_t i, size_t j) {
+        if (X[i] == Y[j]) {
+            C(i + 1, j + 1) = C(i, j) + 1;
+            B(i, j) = Dir::upleft;
+        } else if (C(i, j + 1) >= C(i + 1, j)) {
+            C(i + 1, j + 1) = C(i, j + 1);
+            B(i, j) = Dir::up;
+        } else {
+            C(i + 1, j + 1) = C(i + 1, j);
+            B(i, j) = Dir::left;
+        }
+    }, num_threads);
+    return {C, B};
+}
+
+template <typename T>
+std::vector<T> ExtractLCS(const Table<Dir>& B, const std::vector<T>& X, size_t i, size_t j) {
+    std::vector<T> res;
+    while (i && j) {
+        if (B(i - 1, j - 1) == Dir::upleft) {
+            res.push_back(X[i - 1]);
+            i--;
+            j--;
+        } else if (B(i - 1, j - 1) == Dir::up) {
+            i--;
+        } else {
+            j--;
+        }
+    }
+    sr::reverse(res);
+    return res;
+}
+
+int main() {
+    std::vector<size_t> p {30, 35, 15, 5, 10, 20, 25};
+    auto [m, s] = ParallelMatrixChainOrder(p, 4);
+    PrintOptimalParens(s, 0, 5);
+    std::cout << '\n' << ParallelLongestPalindromicSubsequence("character", 4) << '\n';
+
+    std::mt19937 gen(std::random_device{}());
+    for (size_t iter = 0; iter < 30; iter++) {
+        const size_t n = 1 + gen() % 200;
+        const size_t threads = 1 + gen() % 4;
+        std::vector<size_t> dims (n + 1);
+        for (auto& d : dims) {
+            d = 1 + gen() % 100;
+        }
+        auto [m1, s1] = MatrixChainOrder(dims);
+        auto [m2, s2] = ParallelMatrixChainOrder(dims, threads);
+        for (size_t i = 0; i < n; i++) {
+            for (size_t j = i; j < n; j++) {
+                assert(m1[i][j] == m2(i, j) && s1[i][j] == s2(i, j));
+            }
+        }
+
+        std::vector<double> pk (n + 1), qk (n + 1);
+        for (size_t i = 0; i <= n; i++) {
+            pk[i] = i ? static_cast<double>(gen() % 1000) : 0.0;
+            qk[i] = static_cast<double>(gen() % 1000);
+        }
+        auto [e1, r1] = OptimalBST(pk, qk);
+        auto [e2, r2] = ParallelOptimalBST(pk, qk, threads);
+        assert(e1[1][n] == e2(1, n) && r1[1][n] == r2(1, n));
+
+        std::string str (gen() % 300, ' ');
+        for (auto& c : str) {
+            c = static_cast<char>('a' + gen() % 4);
+        }
+        if (!str.empty()) {
+            assert(LongestPalindromicSubsequence(str) == ParallelLongestPalindromicSubsequence(str, threads));
+        }
+
+        std::vector<int> X (gen() % 700), Y (gen() % 700);
+        for (auto& x : X) {
+            x = static_cast<int>(gen() % 4);
+        }
+        for (auto& y : Y) {
+            y = static_cast<int>(gen() % 4);
+        }
+        auto [C1, B1] = LCSLength(X, Y);
+        auto [C2, B2] = ParallelLCSLength(X, Y, threads);
+        assert(C1[X.size()][Y.size()] == C2(X.size(), Y.size()));
+        assert(ExtractLCS(B2, X, X.size(), Y.size()).size() == C2(X.size(), Y.size()));
+    }
+
+    const size_t threads = std::max(4u, std::thread::hardware_concurrency());
+    auto bench = [threads](const char* name, auto serial, auto parallel) {
+        auto t1 = crn::steady_clock::now();
+        serial();
+        auto t2 = crn::steady_clock::now();
+        parallel();
+        auto t3 = crn::steady_clock::now();
+        std::cout << name << ", serial : " << crn::duration_cast<crn::milliseconds>(t2 - t1).count() << "ms, "
+                  << threads << " threads : " << crn::duration_cast<crn::milliseconds>(t3 - t2).count() << "ms\n";
+    };
+    std::vector<size_t> dims (1'201);
+    for (auto& d : dims) {
+        d = 1 + gen() % 100;
+    }
+    bench("Matrix chain, n = 1200", [&] { MatrixChainOrder(dims); }, [&] { ParallelMatrixChainOrder(dims, threads); });
+    std::vector<double> pk (1'201), qk (1'201);
+    for (size_t i = 0; i < pk.size(); i++) {
+        pk[i] = static_cast<double>(gen() % 1000);
+        qk[i] = static_cast<double>(gen() % 1000);
+    }
+    bench("Optimal BST, n = 1200", [&] { OptimalBST(pk, qk); }, [&] { ParallelOptimalBST(pk, qk, threads); });
+    std::string str (5'000, ' ');
+    for (auto& c : str) {
+        c = static_cast<char>('a' + gen() % 26);
+    }
+    bench("Palindromic subsequence, n = 5000", [&] { LongestPalindromicSubsequence(str); },
+          [&] { ParallelLongestPalindromicSubsequence(str, threads); });
+    std::vector<char> X (5'000), Y (5'000);
+    for (size_t i = 0; i < X.size(); i++) {
+        X[i] = static_cast<char>('a' + gen() % 26);
+        Y[i] = static_cast<char>('a' + gen() % 26);
+    }
+    bench("LCS, 5000 x 5000", [&] { LCSLength(X, Y); }, [&] { ParallelLCSLength(X, Y, threads); });
+}
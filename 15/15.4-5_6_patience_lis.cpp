@@ -0,0 +1,182 @@
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <ranges>
+#include <vector>
+
+namespace crn = std::chrono;
+namespace sr = std::ranges;
+
+template <typename T>
+std::vector<T> LongestIncreasingSubsequence(const std::vector<T>& X) {
+    assert(!X.empty());
+    std::vector<std::vector<T>> LIS;
+    std::vector<T> endpoints;
+    LIS.push_back(std::vector<T>({X[0]}));
+    endpoints.push_back(X[0]);
+
+    for (size_t i = 1; i < X.size(); i++) {
+        auto insertionPoint = sr::lower_bound(endpoints, X[i]);
+        if (insertionPoint == endpoints.end()) {
+            LIS.push_back(LIS.back());
+            LIS.back().push_back(X[i]);
+            endpoints.push_back(X[i]);
+        } else {
+            *insertionPoint = X[i];
+            auto index = std::distance(endpoints.begin(), insertionPoint);
+            LIS[index].back() = X[i];
+        }
+    }
+    return LIS.back();
+}
+
+enum class Order {
+    Increasing,
+    NonDecreasing
+};
+
+// may x follow y in a subsequence of this order?
+template <typename T>
+bool Follows(Order order, const T& y, const T& x) {
+    return order == Order::Increasing ? y < x : !(x < y);
+}
+
+// first position p in a[0, n) with !less(a[p], x). the halving step is a conditional move, so
+// the loop runs log n times with no branch on the data
+template <typename T, typename Less>
+size_t BranchlessLowerBound(const T* a, size_t n, const T& x, Less less) {
+    if (n == 0) {
+        return 0;
+    }
+    const T* base = a;
+    while (n > 1) {
+        const size_t half = n / 2;
+        base = less(base[half], x) ? base + half : base;
+        n -= half;
+    }
+    return static_cast<size_t>(base - a) + less(*base, x);
+}
+
+// patience sorting: tops[k] is the smallest last element of a subsequence of length k + 1 so
+// far, and each element goes on the first pile whose top it may not follow. pred links every
+// element to the top of the pile to its left, so the last pile's top leads back through a
+// longest subsequence. O(n log L) time for a longest subsequence of length L.
+template <typename T>
+std::vector<size_t> PatienceLIS(const std::vector<T>& X, Order order = Order::Increasing) {
+    assert(X.size() < std::numeric_limits<std::uint32_t>::max());
+    std::vector<T> tops;
+    std::vector<std::uint32_t> top_index;
+    std::vector<std::uint32_t> pred (X.size());
+    for (size_t i = 0; i < X.size(); i++) {
+        const T& x = X[i];
+        const size_t p = order == Order::Increasing
+                ? BranchlessLowerBound(tops.data(), tops.size(), x, [](const T& a, const T& b) { return a < b; })
+                : BranchlessLowerBound(tops.data(), tops.size(), x, [](const T& a, const T& b) { return !(b < a); });
+        if (p == tops.size()) {
+            tops.push_back(x);
+            top_index.push_back(static_cast<std::uint32_t>(i));
+        } else {
+            tops[p] = x;
+            top_index[p] = static_cast<std::uint32_t>(i);
+        }
+        pred[i] = p ? top_index[p - 1] : static_cast<std::uint32_t>(i);
+    }
+    std::vector<size_t> res (tops.size());
+    for (size_t k = tops.size(), i = k ? top_index.back() : 0; k-- > 0; i = pred[i]) {
+        res[k] = i;
+    }
+    return res;
+}
+
+int main() {
+    std::vector<int> v {0, 8, 4, 12, 2, 10, 6, 14, 1, 9, 5, 13, 3, 11, 7, 15};
+    auto LIS = PatienceLIS(v);
+    for (auto i : LIS) {
+        std::cout << v[i] << ' ';
+    }
+    std::cout << '\n';
+    assert(LIS.size() == LongestIncreasingSubsequence(v).size());
+
+    auto is_subsequence = [](const auto& X, const std::vector<size_t>& idx, Order order) {
+        for (size_t k = 1; k < idx.size(); k++) {
+            if (idx[k - 1] >= idx[k] || !Follows(order, X[idx[k - 1]], X[idx[k]])) {
+                return false;
+            }
+        }
+        return true;
+    };
+    auto quadratic_length = [](const auto& X, Order order) {
+        std::vector<size_t> len (X.size(), 1);
+        size_t best = 0;
+        for (size_t i = 0; i < X.size(); i++) {
+            for (size_t j = 0; j < i; j++) {
+                if (Follows(order, X[j], X[i])) {
+                    len[i] = std::max(len[i], len[j] + 1);
+                }
+            }
+            best = std::max(best, len[i]);
+        }
+        return best;
+    };
+
+    std::mt19937 gen(std::random_device{}());
+    for (size_t iter = 0; iter < 300; iter++) {
+        std::vector<int> X (gen() % 300);
+        const int range = iter % 2 ? 10 : 1000; // many ties, then few
+        for (auto& x : X) {
+            x = static_cast<int>(gen() % range);
+        }
+        for (auto order : {Order::Increasing, Order::NonDecreasing}) {
+            const auto expected = quadratic_length(X, order);
+            auto patience = PatienceLIS(X, order);
+            assert(patience.size() == expected && is_subsequence(X, patience, order));
+        }
+        if (!X.empty()) {
+            assert(PatienceLIS(X).size() == LongestIncreasingSubsequence(X).size());
+        }
+    }
+    for (size_t iter = 0; iter < 10; iter++) {
+        std::vector<double> X (100'000);
+        for (auto& x : X) {
+            x = std::uniform_real_distribution<>(0, 1)(gen);
+        }
+        auto patience = PatienceLIS(X);
+        assert(patience.size() == LongestIncreasingSubsequence(X).size() && is_subsequence(X, patience, Order::Increasing));
+    }
+
+    // random walks of 10^7 and 10^8 steps
+    auto lower_bound_length = [](const auto& X) {
+        std::vector<std::int32_t> tops;
+        for (auto x : X) {
+            auto it = sr::lower_bound(tops, x);
+            if (it == tops.end()) {
+                tops.push_back(x);
+            } else {
+                *it = x;
+            }
+        }
+        return tops.size();
+    };
+    for (size_t n : {10'000'000, 100'000'000}) {
+        std::vector<std::int32_t> X (n);
+        std::int32_t level = 0;
+        for (auto& x : X) {
+            level += static_cast<std::int32_t>(gen() % 201) - 100;
+            x = level;
+        }
+        auto t1 = crn::steady_clock::now();
+        auto length = lower_bound_length(X);
+        auto t2 = crn::steady_clock::now();
+        auto patience = PatienceLIS(X);
+        auto t3 = crn::steady_clock::now();
+        std::cout << n << " steps, longest increasing subsequence " << patience.size() << '\n';
+        assert(patience.size() == length && is_subsequence(X, patience, Order::Increasing));
+        std::cout << "Patience sorting with std::lower_bound, length only : " << crn::duration_cast<crn::milliseconds>(t2 - t1).count() << "ms\n";
+        std::cout << "Patience sorting with branch-free search : " << crn::duration_cast<crn::milliseconds>(t3 - t2).count() << "ms\n";
+    }
+}
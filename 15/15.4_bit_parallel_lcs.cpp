@@ -0,0 +1,309 @@
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <ranges>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace crn = std::chrono;
+namespace sr = std::ranges;
+
+using u64 = std::uint64_t;
+
+enum class Dir {
+    upleft,
+    up,
+    left,
+};
+
+template <typename T>
+std::pair<std::vector<std::vector<size_t>>, std::vector<std::vector<Dir>>>
+LCSLength(const std::vector<T>& X, const std::vector<T>& Y) {
+    std::vector<std::vector<Dir>> B (X.size(), std::vector<Dir>(Y.size(), Dir::upleft));
+    std::vector<std::vector<size_t>> C (X.size() + 1, std::vector<size_t>(Y.size() + 1));
+    for (size_t i = 0; i < X.size(); i++) {
+        for (size_t j = 0; j < Y.size(); j++) {
+            if (X[i] == Y[j]) {
+                C[i + 1][j + 1] = C[i][j] + 1;
+                B[i][j] = Dir::upleft;
+            } else if (C[i][j + 1] >= C[i + 1][j]) {
+                C[i + 1][j + 1] = C[i][j + 1];
+                B[i][j] = Dir::up;
+            } else {
+                C[i + 1][j + 1] = C[i + 1][j];
+                B[i][j] = Dir::left;
+            }
+        }
+    }
+    return {C, B};
+}
+
+constexpr std::uint32_t none = UINT32_MAX;
+
+// elements of X and Y as dense ids in [0, sigma); elements of Y that do not occur in X get sigma
+template <typename T>
+std::pair<std::vector<std::uint32_t>, std::vector<std::uint32_t>>
+Symbolize(const std::vector<T>& X, const std::vector<T>& Y, size_t& sigma) {
+    std::vector<T> alphabet (X);
+    sr::sort(alphabet);
+    auto [first, last] = sr::unique(alphabet);
+    alphabet.erase(first, last);
+    sigma = alphabet.size();
+    auto id = [&alphabet](const T& x) {
+        auto it = sr::lower_bound(alphabet, x);
+        return (it != alphabet.end() && *it == x) ? static_cast<std::uint32_t>(it - alphabet.begin())
+                                                  : static_cast<std::uint32_t>(alphabet.size());
+    };
+    std::vector<std::uint32_t> a (X.size());
+    std::vector<std::uint32_t> b (Y.size());
+    sr::transform(X, a.begin(), id);
+    sr::transform(Y, b.begin(), id);
+    return {a, b};
+}
+
+// Allison-Dix / Hyyro. bit i of V is 0 iff row i of the LCS table steps up in the current column;
+// one column costs O(|a| / 64) word operations:
+//   U = V & M[b_j], V = (V + U) | (V & ~M[b_j])
+// a symbol occurring more than |a| / 64 times in a keeps its mask M for the whole row; there
+// are at most 64 of those. the mask of any other symbol is assembled from its occurrence chain
+// and cleared again, in fewer steps than the column takes, so memory stays O(|a|) rather than
+// one mask per symbol. returns LCS(a, b[0 .. j)) for every j if all_prefixes, otherwise only
+// LCS(a, b). head must be all none on entry, and is left so.
+std::vector<size_t> LCSRow(std::span<const std::uint32_t> a, std::span<const std::uint32_t> b,
+                           std::vector<std::uint32_t>& head, bool all_prefixes) {
+    const size_t m = a.size();
+    const size_t n = b.size();
+    const size_t nw = (m + 63) / 64;
+    std::vector<std::uint32_t> next (m);
+    std::vector<std::uint32_t> slot (m); // occurrences of a[i] from i on, then at a first occurrence its mask
+    for (size_t i = m; i-- > 0;) {
+        next[i] = head[a[i]];
+        slot[i] = 1 + (next[i] != none ? slot[next[i]] : 0);
+        head[a[i]] = static_cast<std::uint32_t>(i);
+    }
+    std::vector<u64> masks;
+    for (size_t i = 0; i < m; i++) {
+        if (head[a[i]] != i) {
+            continue;
+        }
+        if (slot[i] <= nw) {
+            slot[i] = none;
+            continue;
+        }
+        slot[i] = static_cast<std::uint32_t>(masks.size() / nw);
+        masks.resize(masks.size() + nw);
+        u64* mask = masks.data() + slot[i] * nw;
+        for (auto p = static_cast<std::uint32_t>(i); p != none; p = next[p]) {
+            mask[p / 64] |= u64 {1} << (p % 64);
+        }
+    }
+    std::vector<u64> V (nw, ~u64 {0}); // bits past m stay set
+    std::vector<u64> chain (nw);
+    std::vector<size_t> L (all_prefixes ? n + 1 : 1);
+    for (size_t j = 0; j < n; j++) {
+        const std::uint32_t first = b[j] < head.size() ? head[b[j]] : none;
+        const bool dense = first != none && slot[first] != none;
+        const u64* M = dense ? masks.data() + slot[first] * nw : chain.data();
+        if (!dense) {
+            for (auto p = first; p != none; p = next[p]) {
+                chain[p / 64] |= u64 {1} << (p % 64);
+            }
+        }
+        u64 carry = 0;
+        for (size_t w = 0; w < nw; w++) {
+            const u64 u = V[w] & M[w];
+            const u64 t = V[w] + u;
+            const u64 s = t + carry;
+            carry = (t < V[w]) | (s < t);
+            V[w] = s | (V[w] & ~M[w]);
+        }
+        if (!dense) {
+            for (auto p = first; p != none; p = next[p]) {
+                chain[p / 64] = 0;
+            }
+        }
+        if (all_prefixes) {
+            size_t ones = 0;
+            for (auto v : V) {
+                ones += std::popcount(v);
+            }
+            L[j + 1] = nw * 64 - ones;
+        }
+    }
+    if (!all_prefixes) {
+        size_t ones = 0;
+        for (auto v : V) {
+            ones += std::popcount(v);
+        }
+        L[0] = nw * 64 - ones;
+    }
+    for (auto c : a) {
+        head[c] = none;
+    }
+    return L;
+}
+
+template <typename T>
+size_t BitParallelLCSLength(const std::vector<T>& X, const std::vector<T>& Y) {
+    size_t sigma = 0;
+    auto [a, b] = Symbolize(X, Y, sigma);
+    std::vector<std::uint32_t> head (sigma + 1, none);
+    return LCSRow(a, b, head, false)[0];
+}
+
+// appends the indices into a (offset by a_offset) of one LCS of a and b
+void HirschbergLCS(std::span<const std::uint32_t> a, std::span<const std::uint32_t> b, size_t a_offset,
+                   std::vector<std::uint32_t>& head, std::vector<size_t>& res) {
+    const size_t m = a.size();
+    const size_t n = b.size();
+    if (!m || !n) {
+        return;
+    }
+    if (m == 1) { // mid would be 0 and the split would repeat this subproblem
+        if (sr::find(b, a[0]) != b.end()) {
+            res.push_back(a_offset);
+        }
+        return;
+    }
+    if (m * n <= 4096) {
+        // quadratic table with traceback for small subproblems
+        std::vector<std::uint16_t> C ((m + 1) * (n + 1));
+        for (size_t i = 1; i <= m; i++) {
+            for (size_t j = 1; j <= n; j++) {
+                C[i * (n + 1) + j] = (a[i - 1] == b[j - 1]) ? C[(i - 1) * (n + 1) + j - 1] + 1
+                                   : std::max(C[(i - 1) * (n + 1) + j], C[i * (n + 1) + j - 1]);
+            }
+        }
+        const size_t start = res.size();
+        for (size_t i = m, j = n; i && j;) {
+            if (a[i - 1] == b[j - 1]) {
+                res.push_back(a_offset + i - 1);
+                i--;
+                j--;
+            } else if (C[(i - 1) * (n + 1) + j] >= C[i * (n + 1) + j - 1]) {
+                i--;
+            } else {
+                j--;
+            }
+        }
+        std::reverse(res.begin() + static_cast<std::ptrdiff_t>(start), res.end());
+        return;
+    }
+    // split a in half; the best split of b maximizes LCS(top, b[0 .. j)) + LCS(bottom, b[j .. n))
+    const size_t mid = m / 2;
+    auto L1 = LCSRow(a.subspan(0, mid), b, head, true);
+    std::vector<std::uint32_t> a_rev (a.begin() + static_cast<std::ptrdiff_t>(mid), a.end());
+    std::vector<std::uint32_t> b_rev (b.begin(), b.end());
+    sr::reverse(a_rev);
+    sr::reverse(b_rev);
+    auto L2 = LCSRow(a_rev, b_rev, head, true);
+    size_t split = 0;
+    for (size_t j = 1; j <= n; j++) {
+        if (L1[j] + L2[n - j] > L1[split] + L2[n - split]) {
+            split = j;
+        }
+    }
+    HirschbergLCS(a.subspan(0, mid), b.subspan(0, split), a_offset, head, res);
+    HirschbergLCS(a.subspan(mid), b.subspan(split), a_offset + mid, head, res);
+}
+
+// one LCS in O(|X| |Y| / 64) time and O(|X| + |Y| + sigma) memory
+template <typename T>
+std::vector<T> HirschbergLCS(const std::vector<T>& X, const std::vector<T>& Y) {
+    size_t sigma = 0;
+    auto [a, b] = Symbolize(X, Y, sigma);
+    std::vector<std::uint32_t> head (sigma + 1, none);
+    std::vector<size_t> indices;
+    HirschbergLCS(a, b, 0, head, indices);
+    std::vector<T> res;
+    res.reserve(indices.size());
+    for (auto i : indices) {
+        res.push_back(X[i]);
+    }
+    return res;
+}
+
+template <typename T>
+bool IsSubsequence(const std::vector<T>& Z, const std::vector<T>& X) {
+    size_t k = 0;
+    for (size_t i = 0; i < X.size() && k < Z.size(); i++) {
+        k += X[i] == Z[k];
+    }
+    return k == Z.size();
+}
+
+int main() {
+    std::vector<char> X = {'A', 'B', 'C', 'B', 'D', 'A', 'B'};
+    std::vector<char> Y = {'B', 'D', 'C', 'A', 'B', 'A'};
+    assert(BitParallelLCSLength(X, Y) == 4);
+    for (auto c : HirschbergLCS(X, Y)) {
+        std::cout << c;
+    }
+    std::cout << '\n';
+
+    std::mt19937 gen(std::random_device{}());
+    auto random_vector = [&gen](size_t len, int hi) {
+        std::uniform_int_distribution<> dist(0, hi);
+        std::vector<int> v (len);
+        for (auto& x : v) {
+            x = dist(gen);
+        }
+        return v;
+    };
+    for (size_t iter = 0; iter < 300; iter++) {
+        auto A = random_vector(gen() % 300, 1 + static_cast<int>(iter % 10));
+        auto B = random_vector(gen() % 300, 1 + static_cast<int>(iter % 7));
+        const size_t expected = LCSLength(A, B).first[A.size()][B.size()];
+        assert(BitParallelLCSLength(A, B) == expected);
+        auto Z = HirschbergLCS(A, B);
+        assert(Z.size() == expected && IsSubsequence(Z, A) && IsSubsequence(Z, B));
+    }
+    // one element against more than the table base case holds, both ways round
+    for (size_t iter = 0; iter < 10; iter++) {
+        auto A = random_vector(1, 9);
+        auto B = random_vector(5000, iter % 2 ? 9 : 100'000);
+        const size_t expected = sr::find(B, A[0]) != B.end();
+        auto Z = HirschbergLCS(A, B);
+        assert(BitParallelLCSLength(A, B) == expected && Z.size() == expected && IsSubsequence(Z, B));
+        Z = HirschbergLCS(B, A);
+        assert(BitParallelLCSLength(B, A) == expected && Z.size() == expected && IsSubsequence(Z, B));
+    }
+
+    // two versions of a 100k-line file
+    std::vector<std::string> lines (100'000);
+    for (auto& line : lines) {
+        line = "line " + std::to_string(gen() % 20'000);
+    }
+    auto edited = lines;
+    for (size_t k = 0; k < 2'000; k++) {
+        edited[gen() % edited.size()] = "edited " + std::to_string(k);
+    }
+    auto t1 = crn::steady_clock::now();
+    auto len = BitParallelLCSLength(lines, edited);
+    auto t2 = crn::steady_clock::now();
+    auto Z = HirschbergLCS(lines, edited);
+    auto t3 = crn::steady_clock::now();
+    assert(Z.size() == len && IsSubsequence(Z, lines) && IsSubsequence(Z, edited));
+    std::cout << "100k x 100k lines, LCS = " << len << '\n';
+    std::cout << "Bit-parallel length : " << crn::duration_cast<crn::milliseconds>(t2 - t1).count() << "ms\n";
+    std::cout << "Hirschberg traceback : " << crn::duration_cast<crn::milliseconds>(t3 - t2).count() << "ms\n";
+
+    // two binary strings of 100k symbols: every symbol occurs about |X| / 2 times
+    auto bits_X = random_vector(100'000, 1);
+    auto bits_Y = random_vector(100'000, 1);
+    auto t4 = crn::steady_clock::now();
+    auto bits_len = BitParallelLCSLength(bits_X, bits_Y);
+    auto t5 = crn::steady_clock::now();
+    auto bits_Z = HirschbergLCS(bits_X, bits_Y);
+    auto t6 = crn::steady_clock::now();
+    assert(bits_Z.size() == bits_len && IsSubsequence(bits_Z, bits_X) && IsSubsequence(bits_Z, bits_Y));
+    std::cout << "100k x 100k bits, LCS = " << bits_len << '\n';
+    std::cout << "Bit-parallel length : " << crn::duration_cast<crn::milliseconds>(t5 - t4).count() << "ms\n";
+    std::cout << "Hirschberg traceback : " << crn::duration_cast<crn::milliseconds>(t6 - t5).count() << "ms\n";
+}
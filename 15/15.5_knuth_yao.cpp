@@ -0,0 +1,353 @@
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace crn = std::chrono;
+
+// cubic versions from 15-9 and 15.5-1, for the self-check
+
+// C[i][j] is the cheapest cost of the breaks strictly between B[i] and B[j]
+std::vector<std::vector<size_t>> BreakStringTable(const std::vector<size_t>& B) {
+    size_t m = B.size() - 2;
+    std::vector<std::vector<size_t>> C (m + 1, std::vector<size_t> (m + 2));
+    for (size_t i = m - 1; i < m; i--) {
+        for (size_t j = i + 2; j <= m + 1; j++) {
+            C[i][j] = std::numeric_limits<size_t>::max();
+            for (size_t k = i + 1; k <= j - 1; k++) {
+                C[i][j] = std::min({C[i][j], C[i][k] + C[k][j] + B[j] - B[i]});
+            }
+        }
+    }
+    return C;
+}
+
+size_t BreakString(size_t n, std::vector<size_t>& B) {
+    size_t m = B.size();
+    std::vector<size_t> B_ (m + 2);
+    B_[m + 1] = n;
+    for (size_t i = 1; i <= m; i++) {
+        B_[i] = B[i - 1];
+    }
+    B = B_;
+    return BreakStringTable(B)[0][m + 1];
+}
+
+// key k_j has probability p[j - 1], dummy key d_j has q[j]
+std::pair<std::vector<std::vector<double>>, std::vector<std::vector<size_t>>>
+OptimalBST(const std::vector<double>& p, const std::vector<double>& q) {
+    size_t n = p.size();
+    std::vector<std::vector<double>> expect (n + 2, std::vector<double>(n + 1));
+    std::vector<std::vector<double>> partialProbSum (n + 2, std::vector<double>(n + 1));
+    std::vector<std::vector<size_t>> root (n + 1, std::vector<size_t>(n + 1));
+    for (size_t i = 1; i <= n + 1; i++) {
+        expect[i][i - 1] = q[i - 1];
+        partialProbSum[i][i - 1] = q[i - 1];
+    }
+    for (size_t l = 1; l <= n; l++) { // l : length of chain
+        for (size_t i = 1; i <= n - l + 1; i++) { // begin
+            size_t j = i + l - 1; // end
+            expect[i][j] = std::numeric_limits<double>::max();
+            partialProbSum[i][j] = partialProbSum[i][j - 1] + p[j - 1] + q[j];
+            for (size_t r = i; r <= j; r++) { // root
+                double v = expect[i][r - 1] + expect[r + 1][j] + partialProbSum[i][j];
+                if (v < expect[i][j]) {
+                    expect[i][j] = v;
+                    root[i][j] = r;
+                }
+            }
+        }
+    }
+    return {expect, root};
+}
+
+// entries (i, j) for lo <= i <= hi and i + first <= j <= end, row by row in one buffer.
+// an interval DP over n points needs about n^2 / 2 entries instead of a square of vectors.
+template <typename T>
+class TriangularTable {
+    size_t lo = 0;
+    std::ptrdiff_t first = 0;
+    std::vector<size_t> row_begin;
+    std::vector<T> data;
+
+public:
+    TriangularTable(size_t lo_, size_t hi, std::ptrdiff_t first_, size_t end) : lo {lo_}, first {first_}, row_begin (hi - lo_ + 2) {
+        for (size_t i = lo; i <= hi; i++) {
+            const auto row_first = static_cast<std::ptrdiff_t>(i) + first;
+            const size_t len = static_cast<std::ptrdiff_t>(end) >= row_first ? end - static_cast<size_t>(row_first) + 1 : 0;
+            row_begin[i - lo + 1] = row_begin[i - lo] + len;
+        }
+        data.resize(row_begin.back());
+    }
+
+    T& operator()(size_t i, size_t j) {
+        return data[row_begin[i - lo] + static_cast<size_t>(static_cast<std::ptrdiff_t>(j) - static_cast<std::ptrdiff_t>(i) - first)];
+    }
+
+    const T& operator()(size_t i, size_t j) const {
+        return data[row_begin[i - lo] + static_cast<size_t>(static_cast<std::ptrdiff_t>(j) - static_cast<std::ptrdiff_t>(i) - first)];
+    }
+};
+
+// costs satisfy the quadrangle inequality since B[j] - B[i] is additive, so some optimal
+// first break of [i, j] lies between those of [i, j - 1] and [i + 1, j] (Knuth, Yao).
+// the search ranges telescope along each row, O(m^2) overall.
+TriangularTable<size_t> KnuthBreakStringTable(size_t n, const std::vector<size_t>& breaks) {
+    const size_t m = breaks.size();
+    std::vector<size_t> B (m + 2);
+    B[m + 1] = n;
+    std::copy(breaks.begin(), breaks.end(), B.begin() + 1);
+    TriangularTable<size_t> C (0, m + 1, 1, m + 1);
+    TriangularTable<std::uint32_t> K (0, m + 1, 1, m + 1);
+    for (size_t i = 0; i <= m; i++) {
+        K(i, i + 1) = static_cast<std::uint32_t>(i);
+    }
+    for (size_t i = m; i-- > 0;) {
+        for (size_t j = i + 2; j <= m + 1; j++) {
+            const size_t k_lo = std::max<size_t>(K(i, j - 1), i + 1);
+            const size_t k_hi = std::min<size_t>(K(i + 1, j), j - 1);
+            size_t best = std::numeric_limits<size_t>::max();
+            size_t best_k = k_lo;
+            for (size_t k = k_lo; k <= std::max(k_lo, k_hi); k++) {
+                auto v = C(i, k) + C(k, j);
+                if (v < best) {
+                    best = v;
+                    best_k = k;
+                }
+            }
+            C(i, j) = best + B[j] - B[i];
+            K(i, j) = static_cast<std::uint32_t>(best_k);
+        }
+    }
+    return C;
+}
+
+size_t KnuthBreakString(size_t n, const std::vector<size_t>& breaks) {
+    return KnuthBreakStringTable(n, breaks)(0, breaks.size() + 1);
+}
+
+struct OptimalBSTTables {
+    TriangularTable<double> expect; // (i, j) for 1 <= i <= n + 1, i - 1 <= j <= n
+    TriangularTable<std::uint32_t> root; // (i, j) for 1 <= i <= j <= n, same layout
+};
+
+// Knuth's bound root[i][j - 1] <= root[i][j] <= root[i + 1][j] (exercise 15.5-4) in O(n^2)
+// time and about 12 bytes per interval. weights come from prefix sums instead of a table.
+OptimalBSTTables KnuthOptimalBST(const std::vector<double>& p, const std::vector<double>& q) {
+    const size_t n = p.size();
+    assert(q.size() == n + 1);
+    std::vector<double> prefix (n + 2); // prefix[j] = p[0 .. j) + q[0 .. j)
+    for (size_t j = 0; j <= n; j++) {
+        prefix[j + 1] = prefix[j] + (j < n ? p[j] : 0.0) + q[j];
+    }
+    auto weight = [&](size_t i, size_t j) { // p_i .. p_j, q_{i-1} .. q_j
+        return prefix[j] - prefix[i - 1] + q[j];
+    };
+    OptimalBSTTables T {{1, n + 1, -1, n}, {1, n + 1, -1, n}};
+    for (size_t i = 1; i <= n + 1; i++) {
+        T.expect(i, i - 1) = q[i - 1];
+    }
+    // rows bottom-up, so root(i + 1, j) is final before row i, and row i of expect stays in cache
+    for (size_t i = n; i >= 1; i--) {
+        for (size_t j = i; j <= n; j++) {
+            const size_t r_lo = j == i ? i : T.root(i, j - 1);
+            const size_t r_hi = j == i ? i : T.root(i + 1, j);
+            double best = std::numeric_limits<double>::max();
+            size_t best_r = r_lo;
+            for (size_t r = r_lo; r <= r_hi; r++) {
+                double v = T.expect(i, r - 1) + T.expect(r + 1, j);
+                if (v < best) {
+                    best = v;
+                    best_r = r;
+                }
+            }
+            T.expect(i, j) = best + weight(i, j);
+            T.root(i, j) = static_cast<std::uint32_t>(best_r);
+        }
+    }
+    return T;
+}
+
+void ConstructOptimalBst(const TriangularTable<std::uint32_t>& root,
+        size_t i, size_t j, size_t last, size_t& d_index) {
+    if (i > j) {
+        if (j < last) {
+            std::cout << "d_" << d_index++ << " is the left child of k_" << last << "\n";
+        } else {
+            std::cout << "d_" << d_index++ << " is the right child of k_" << last << "\n";
+        }
+        return;
+    }
+    if (last == 0) {
+        std::cout << "k_" << root(i, j) << " is the root\n";
+    } else if (j < last) {
+        std::cout << "k_" << root(i, j) << " is the left child of k_" << last << "\n";
+    } else {
+        std::cout << "k_" << root(i, j) << " is the right child of k_" << last << "\n";
+    }
+    ConstructOptimalBst(root, i, root(i, j) - 1, root(i, j), d_index);
+    ConstructOptimalBst(root, root(i, j) + 1, j, root(i, j), d_index);
+}
+
+// with optimal(i, j, k) telling whether split k is optimal for interval (i, j), does some
+// optimal split of every interval (i, j) in [lo, hi] lie between an optimal split of
+// (i, j - 1) and one of (i + 1, j)? intervals with j - i >= min_len have splits, which run
+// over [i + skip, j - skip]. this is the monotonicity the restricted search relies on.
+template <typename Optimal>
+bool MonotoneSplits(size_t lo, size_t hi, size_t min_len, size_t skip, Optimal optimal) {
+    auto first = [&](size_t i, size_t j) {
+        size_t k = i + skip;
+        while (!optimal(i, j, k)) {
+            k++;
+        }
+        return k;
+    };
+    auto last = [&](size_t i, size_t j) {
+        size_t k = j - skip;
+        while (!optimal(i, j, k)) {
+            k--;
+        }
+        return k;
+    };
+    for (size_t i = lo; i <= hi; i++) {
+        for (size_t j = i + min_len + 1; j <= hi; j++) {
+            bool found = false;
+            for (size_t k = first(i, j - 1), k_hi = last(i + 1, j); k <= k_hi && !found; k++) {
+                found = optimal(i, j, k);
+            }
+            if (!found) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// self-check: the restricted search must reproduce the cubic DP on every interval, and the
+// optimal splits of the cubic DP must be monotone as the restriction assumes (any optimal
+// split counts among ties). only meant for small inputs, since the reference is cubic.
+bool KnuthYaoSelfCheck(size_t n, const std::vector<size_t>& breaks) {
+    const size_t m = breaks.size();
+    std::vector<size_t> B (m + 2);
+    B[m + 1] = n;
+    std::copy(breaks.begin(), breaks.end(), B.begin() + 1);
+    auto C = BreakStringTable(B);
+    auto fast = KnuthBreakStringTable(n, breaks);
+    for (size_t i = 0; i <= m; i++) {
+        for (size_t j = i + 1; j <= m + 1; j++) {
+            if (fast(i, j) != C[i][j]) {
+                return false;
+            }
+        }
+    }
+    return MonotoneSplits(0, m + 1, 2, 1, [&](size_t i, size_t j, size_t k) {
+        return C[i][k] + C[k][j] + B[j] - B[i] == C[i][j];
+    });
+}
+
+bool KnuthYaoSelfCheck(const std::vector<double>& p, const std::vector<double>& q) {
+    auto [expect, root] = OptimalBST(p, q);
+    auto fast = KnuthOptimalBST(p, q);
+    const size_t n = p.size();
+    auto close = [](double a, double b) {
+        return std::abs(a - b) <= 1e-9 * std::max(1.0, std::abs(b));
+    };
+    for (size_t i = 1; i <= n; i++) {
+        for (size_t j = i; j <= n; j++) {
+            if (!close(fast.expect(i, j), expect[i][j])) {
+                return false;
+            }
+        }
+    }
+    std::vector<double> prefix (n + 2); // prefix[j] = p[0 .. j) + q[0 .. j)
+    for (size_t j = 0; j <= n; j++) {
+        prefix[j + 1] = prefix[j] + (j < n ? p[j] : 0.0) + q[j];
+    }
+    return MonotoneSplits(1, n, 0, 0, [&](size_t i, size_t j, size_t r) {
+        return close(expect[i][r - 1] + expect[r + 1][j] + prefix[j] - prefix[i - 1] + q[j], expect[i][j]);
+    });
+}
+
+int main() {
+    std::vector<size_t> B {2, 8, 10};
+    std::cout << KnuthBreakString(20, B) << '\n';
+    std::vector<double> p {0.15, 0.10, 0.05, 0.10, 0.20};
+    std::vector<double> q {0.05, 0.10, 0.05, 0.05, 0.05, 0.10};
+    auto tables = KnuthOptimalBST(p, q);
+    std::cout << tables.expect(1, p.size()) << '\n';
+    size_t d_index = 0;
+    ConstructOptimalBst(tables.root, 1, p.size(), 0, d_index);
+
+    // a split rule that jumps back on intervals of even length is caught
+    assert(!MonotoneSplits(0, 6, 2, 1, [](size_t i, size_t j, size_t k) {
+        return k == ((j - i) % 2 ? j - 1 : i + 1);
+    }));
+
+    std::mt19937 gen(std::random_device{}());
+    for (size_t iter = 0; iter < 200; iter++) {
+        const size_t m = 1 + gen() % 60;
+        const size_t n = m + 1 + gen() % 1000;
+        std::vector<size_t> breaks (m);
+        for (auto& b : breaks) {
+            b = 1 + gen() % (n - 1);
+        }
+        std::sort(breaks.begin(), breaks.end());
+        assert(KnuthYaoSelfCheck(n, breaks));
+
+        const size_t keys = 1 + gen() % 60;
+        std::vector<double> pk (keys), qk (keys + 1);
+        for (auto& x : pk) {
+            x = static_cast<double>(gen() % 100);
+        }
+        for (auto& x : qk) {
+            x = static_cast<double>(gen() % 100);
+        }
+        assert(KnuthYaoSelfCheck(pk, qk));
+    }
+
+    // access counts of 2000 keys, then 10000
+    auto random_weights = [&gen](size_t len) {
+        std::vector<double> w (len);
+        for (auto& x : w) {
+            x = static_cast<double>(gen() % 10'000);
+        }
+        return w;
+    };
+    auto pk = random_weights(2'000);
+    auto qk = random_weights(2'001);
+    auto t1 = crn::steady_clock::now();
+    auto cubic = OptimalBST(pk, qk);
+    auto t2 = crn::steady_clock::now();
+    auto fast = KnuthOptimalBST(pk, qk);
+    auto t3 = crn::steady_clock::now();
+    assert(std::abs(cubic.first[1][pk.size()] - fast.expect(1, pk.size())) <= 1e-9 * cubic.first[1][pk.size()]);
+    std::cout << "Optimal BST, n = 2000, cubic : " << crn::duration_cast<crn::milliseconds>(t2 - t1).count()
+              << "ms, Knuth : " << crn::duration_cast<crn::milliseconds>(t3 - t2).count() << "ms\n";
+    pk = random_weights(10'000);
+    qk = random_weights(10'001);
+    auto t4 = crn::steady_clock::now();
+    fast = KnuthOptimalBST(pk, qk);
+    auto t5 = crn::steady_clock::now();
+    std::cout << "Optimal BST, n = 10000, Knuth : " << crn::duration_cast<crn::milliseconds>(t5 - t4).count() << "ms\n";
+
+    std::vector<size_t> breaks (2'000);
+    for (auto& b : breaks) {
+        b = 1 + gen() % 999'999;
+    }
+    std::sort(breaks.begin(), breaks.end());
+    auto copy = breaks;
+    auto t6 = crn::steady_clock::now();
+    auto slow_cost = BreakString(1'000'000, copy);
+    auto t7 = crn::steady_clock::now();
+    auto fast_cost = KnuthBreakString(1'000'000, breaks);
+    auto t8 = crn::steady_clock::now();
+    assert(slow_cost == fast_cost);
+    std::cout << "Break string, m = 2000, cubic : " << crn::duration_cast<crn::milliseconds>(t7 - t6).count()
+              << "ms, Knuth : " << crn::duration_cast<crn::milliseconds>(t8 - t7).count() << "ms\n";
+}
@@ -0,0 +1,520 @@
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <chrono>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace crn = std::chrono;
+
+using u32 = std::uint32_t;
+using u64 = std::uint64_t;
+using i64 = std::int64_t;
+using u128 = unsigned __int128;
+
+// arbitrary precision unsigned integer, base 2^32 limbs in little endian order
+struct BigUnsigned {
+    std::vector<u32> limbs;
+
+    BigUnsigned() = default;
+
+    BigUnsigned(u64 v) {
+        while (v) {
+            limbs.push_back(static_cast<u32>(v));
+            v >>= 32;
+        }
+    }
+
+    explicit BigUnsigned(std::vector<u32> l) : limbs {std::move(l)} {
+        Trim();
+    }
+
+    void Trim() {
+        while (!limbs.empty() && !limbs.back()) {
+            limbs.pop_back();
+        }
+    }
+
+    [[nodiscard]] bool IsZero() const {
+        return limbs.empty();
+    }
+
+    [[nodiscard]] std::size_t Size() const {
+        return limbs.size();
+    }
+
+    [[nodiscard]] u64 ToU64() const {
+        u64 v = 0;
+        for (std::size_t i = std::min<std::size_t>(limbs.size(), 2); i-- > 0;) {
+            v = (v << 32) | limbs[i];
+        }
+        return v;
+    }
+
+    // this * 2^(32k)
+    [[nodiscard]] BigUnsigned ShiftLimbs(std::size_t k) const {
+        if (IsZero()) {
+            return {};
+        }
+        std::vector<u32> res (k + limbs.size());
+        std::copy(limbs.begin(), limbs.end(), res.begin() + k);
+        return BigUnsigned(std::move(res));
+    }
+
+    // this mod 2^(32k)
+    [[nodiscard]] BigUnsigned Low(std::size_t k) const {
+        return BigUnsigned(std::vector<u32>(limbs.begin(), limbs.begin() + std::min(k, limbs.size())));
+    }
+
+    // this / 2^(32k)
+    [[nodiscard]] BigUnsigned High(std::size_t k) const {
+        if (k >= limbs.size()) {
+            return {};
+        }
+        return BigUnsigned(std::vector<u32>(limbs.begin() + k, limbs.end()));
+    }
+
+    [[nodiscard]] std::string ToString() const;
+};
+
+std::strong_ordering operator<=>(const BigUnsigned& a, const BigUnsigned& b) {
+    if (a.Size() != b.Size()) {
+        return a.Size() <=> b.Size();
+    }
+    for (std::size_t i = a.Size(); i-- > 0;) {
+        if (a.limbs[i] != b.limbs[i]) {
+            return a.limbs[i] <=> b.limbs[i];
+        }
+    }
+    return std::strong_ordering::equal;
+}
+
+bool operator==(const BigUnsigned& a, const BigUnsigned& b) {
+    return a.limbs == b.limbs;
+}
+
+BigUnsigned operator+(const BigUnsigned& a, const BigUnsigned& b) {
+    const auto& x = a.Size() >= b.Size() ? a.limbs : b.limbs;
+    const auto& y = a.Size() >= b.Size() ? b.limbs : a.limbs;
+    std::vector<u32> res (x.size() + 1);
+    u64 carry = 0;
+    for (std::size_t i = 0; i < x.size(); i++) {
+        u64 s = static_cast<u64>(x[i]) + (i < y.size() ? y[i] : 0) + carry;
+        res[i] = static_cast<u32>(s);
+        carry = s >> 32;
+    }
+    res[x.size()] = static_cast<u32>(carry);
+    return BigUnsigned(std::move(res));
+}
+
+// requires a >= b
+BigUnsigned operator-(const BigUnsigned& a, const BigUnsigned& b) {
+    assert(a >= b);
+    std::vector<u32> res (a.Size());
+    i64 borrow = 0;
+    for (std::size_t i = 0; i < a.Size(); i++) {
+        i64 t = static_cast<i64>(a.limbs[i]) - (i < b.Size() ? b.limbs[i] : 0) - borrow;
+        borrow = t < 0;
+        res[i] = static_cast<u32>(t);
+    }
+    return BigUnsigned(std::move(res));
+}
+
+BigUnsigned SchoolbookMultiply(const BigUnsigned& a, const BigUnsigned& b) {
+    std::vector<u32> res (a.Size() + b.Size());
+    for (std::size_t i = 0; i < a.Size(); i++) {
+        u64 carry = 0;
+        const u64 ai = a.limbs[i];
+        for (std::size_t j = 0; j < b.Size(); j++) {
+            u64 t = ai * b.limbs[j] + res[i + j] + carry;
+            res[i + j] = static_cast<u32>(t);
+            carry = t >> 32;
+        }
+        res[i + b.Size()] = static_cast<u32>(carry);
+    }
+    return BigUnsigned(std::move(res));
+}
+
+// res += x * 2^(32k), res has room for the sum
+void AddShifted(std::vector<u32>& res, const BigUnsigned& x, std::size_t k) {
+    u64 carry = 0;
+    std::size_t i = 0;
+    for (; i < x.Size(); i++) {
+        u64 s = static_cast<u64>(res[i + k]) + x.limbs[i] + carry;
+        res[i + k] = static_cast<u32>(s);
+        carry = s >> 32;
+    }
+    for (; carry; i++) {
+        u64 s = static_cast<u64>(res[i + k]) + carry;
+        res[i + k] = static_cast<u32>(s);
+        carry = s >> 32;
+    }
+}
+
+constexpr std::size_t karatsuba_threshold = 48;
+
+// Karatsuba, the same three-product split as PolynomialProductLg3 in 30-1
+BigUnsigned operator*(const BigUnsigned& a, const BigUnsigned& b) {
+    if (a.IsZero() || b.IsZero()) {
+        return {};
+    }
+    if (a.Size() > b.Size()) {
+        return b * a;
+    }
+    const std::size_t na = a.Size();
+    const std::size_t nb = b.Size();
+    if (na < karatsuba_threshold) {
+        return SchoolbookMultiply(a, b);
+    }
+    std::vector<u32> res (na + nb + 1);
+    if (2 * na <= nb) {
+        // unbalanced: multiply a by na-limb slices of b
+        for (std::size_t k = 0; k < nb; k += na) {
+            auto slice = BigUnsigned(std::vector<u32>(b.limbs.begin() + k, b.limbs.begin() + std::min(nb, k + na)));
+            AddShifted(res, a * slice, k);
+        }
+        return BigUnsigned(std::move(res));
+    }
+    const std::size_t k = nb / 2;
+    auto a1 = a.High(k);
+    auto a0 = a.Low(k);
+    auto b1 = b.High(k);
+    auto b0 = b.Low(k);
+    auto z2 = a1 * b1;
+    auto z0 = a0 * b0;
+    auto z1 = (a1 + a0) * (b1 + b0) - z2 - z0;
+    AddShifted(res, z0, 0);
+    AddShifted(res, z1, k);
+    AddShifted(res, z2, 2 * k);
+    return BigUnsigned(std::move(res));
+}
+
+std::pair<BigUnsigned, u32> DivModSmall(const BigUnsigned& u, u32 d) {
+    assert(d);
+    std::vector<u32> q (u.Size());
+    u64 r = 0;
+    for (std::size_t i = u.Size(); i-- > 0;) {
+        u64 cur = (r << 32) | u.limbs[i];
+        q[i] = static_cast<u32>(cur / d);
+        r = cur % d;
+    }
+    return {BigUnsigned(std::move(q)), static_cast<u32>(r)};
+}
+
+// Knuth's algorithm D, O((|u| - |v|) * |v|)
+std::pair<BigUnsigned, BigUnsigned> KnuthDivMod(const BigUnsigned& u, const BigUnsigned& v) {
+    assert(!v.IsZero());
+    if (u < v) {
+        return {{}, u};
+    }
+    if (v.Size() == 1) {
+        auto [q, r] = DivModSmall(u, v.limbs[0]);
+        return {q, BigUnsigned(r)};
+    }
+    const std::size_t n = v.Size();
+    const std::size_t m = u.Size() - n;
+    const int s = std::countl_zero(v.limbs.back());
+    std::vector<u32> vn (n);
+    std::vector<u32> un (u.Size() + 1);
+    for (std::size_t i = n - 1; i > 0; i--) {
+        vn[i] = (v.limbs[i] << s) | (s ? static_cast<u32>(static_cast<u64>(v.limbs[i - 1]) >> (32 - s)) : 0);
+    }
+    vn[0] = v.limbs[0] << s;
+    un[u.Size()] = s ? static_cast<u32>(static_cast<u64>(u.limbs.back()) >> (32 - s)) : 0;
+    for (std::size_t i = u.Size() - 1; i > 0; i--) {
+        un[i] = (u.limbs[i] << s) | (s ? static_cast<u32>(static_cast<u64>(u.limbs[i - 1]) >> (32 - s)) : 0);
+    }
+    un[0] = u.limbs[0] << s;
+
+    constexpr u64 base = u64 {1} << 32;
+    std::vector<u32> q (m + 1);
+    for (std::size_t j = m + 1; j-- > 0;) {
+        const u64 num = (static_cast<u64>(un[j + n]) << 32) | un[j + n - 1];
+        u64 qhat = num / vn[n - 1];
+        u64 rhat = num % vn[n - 1];
+        while (qhat >= base || qhat * vn[n - 2] > ((rhat << 32) | un[j + n - 2])) {
+            qhat--;
+            rhat += vn[n - 1];
+            if (rhat >= base) {
+                break;
+            }
+        }
+        i64 k = 0;
+        i64 t = 0;
+        for (std::size_t i = 0; i < n; i++) {
+            u64 p = qhat * vn[i];
+            t = static_cast<i64>(un[i + j]) - k - static_cast<i64>(p & 0xFFFFFFFF);
+            un[i + j] = static_cast<u32>(t);
+            k = static_cast<i64>(p >> 32) - (t >> 32);
+        }
+        t = static_cast<i64>(un[j + n]) - k;
+        un[j + n] = static_cast<u32>(t);
+        q[j] = static_cast<u32>(qhat);
+        if (t < 0) {
+            q[j]--;
+            u64 carry = 0;
+            for (std::size_t i = 0; i < n; i++) {
+                u64 sum = static_cast<u64>(un[i + j]) + vn[i] + carry;
+                un[i + j] = static_cast<u32>(sum);
+                carry = sum >> 32;
+            }
+            un[j + n] += static_cast<u32>(carry);
+        }
+    }
+    std::vector<u32> r (n);
+    for (std::size_t i = 0; i < n; i++) {
+        r[i] = (un[i] >> s) | (s ? static_cast<u32>(static_cast<u64>(un[i + 1]) << (32 - s)) : 0);
+    }
+    return {BigUnsigned(std::move(q)), BigUnsigned(std::move(r))};
+}
+
+constexpr std::size_t newton_threshold = 64;
+
+// floor(2^(32L) / v) by Newton's iteration x <- x + x * (2^(32L) - v * x) / 2^(32L).
+// the start value is the reciprocal of the top limbs of v at half the precision,
+// so only the last one or two steps run at full size.
+BigUnsigned Reciprocal(const BigUnsigned& v, std::size_t L) {
+    const std::size_t k = v.Size();
+    assert(k && L >= k);
+    const BigUnsigned BL = BigUnsigned(1).ShiftLimbs(L);
+    const std::size_t p = L - k + 1; // limbs of the result
+    if (k <= 2 || p < newton_threshold) {
+        return KnuthDivMod(BL, v).first;
+    }
+    const std::size_t ph = p / 2 + 2;
+    const std::size_t t = std::min(k, ph + 1);
+    // rounding the truncated divisor up keeps the start value below the true reciprocal
+    const auto vt = v.High(k - t) + 1;
+    BigUnsigned x = Reciprocal(vt, vt.Size() + ph - 1).ShiftLimbs(p - ph);
+    BigUnsigned prod = v * x;
+    // the iteration approaches from below and stalls only when x is within a few units
+    while (prod <= BL) {
+        auto step = (x * (BL - prod)).High(L);
+        if (step.IsZero()) {
+            break;
+        }
+        x = x + step;
+        prod = v * x;
+    }
+    while (prod > BL) {
+        x = x - 1;
+        prod = prod - v;
+    }
+    BigUnsigned r = BL - prod;
+    while (r >= v) {
+        x = x + 1;
+        r = r - v;
+    }
+    return x;
+}
+
+std::pair<BigUnsigned, BigUnsigned> DivMod(const BigUnsigned& u, const BigUnsigned& v) {
+    if (u < v) {
+        return {{}, u};
+    }
+    if (v.Size() < newton_threshold || u.Size() - v.Size() < newton_threshold) {
+        return KnuthDivMod(u, v);
+    }
+    const std::size_t L = u.Size();
+    auto q = (u * Reciprocal(v, L)).High(L);
+    auto r = u - q * v;
+    while (r >= v) {
+        q = q + 1;
+        r = r - v;
+    }
+    return {q, r};
+}
+
+BigUnsigned operator/(const BigUnsigned& u, const BigUnsigned& v) {
+    return DivMod(u, v).first;
+}
+
+BigUnsigned operator%(const BigUnsigned& u, const BigUnsigned& v) {
+    return DivMod(u, v).second;
+}
+
+std::string BigUnsigned::ToString() const {
+    if (IsZero()) {
+        return "0";
+    }
+    std::string res;
+    BigUnsigned cur = *this;
+    while (!cur.IsZero()) {
+        auto [q, r] = DivModSmall(cur, 1'000'000'000);
+        auto digits = std::to_string(r);
+        if (!q.IsZero()) {
+            digits.insert(0, 9 - digits.size(), '0');
+        }
+        res.insert(0, digits);
+        cur = std::move(q);
+    }
+    return res;
+}
+
+BigUnsigned Euclid(BigUnsigned a, BigUnsigned b) {
+    while (!b.IsZero()) {
+        a = a % b;
+        std::swap(a, b);
+    }
+    return a;
+}
+
+// Bernstein's batch gcd. the product tree is built bottom up, then P mod N_i^2 is pushed down
+// the remainder tree, and gcd((P mod N_i^2) / N_i, N_i) = gcd(N_i, prod_{j != i} N_j).
+std::vector<BigUnsigned> BatchGCD(const std::vector<BigUnsigned>& N) {
+    if (N.empty()) {
+        return {};
+    }
+    std::vector<std::vector<BigUnsigned>> tree {N};
+    while (tree.back().size() > 1) {
+        const auto& level = tree.back();
+        std::vector<BigUnsigned> next ((level.size() + 1) / 2);
+        for (std::size_t i = 0; i < next.size(); i++) {
+            next[i] = (2 * i + 1 < level.size()) ? level[2 * i] * level[2 * i + 1] : level[2 * i];
+        }
+        tree.push_back(std::move(next));
+    }
+    std::vector<BigUnsigned> rem = tree.back();
+    for (std::size_t l = tree.size() - 1; l-- > 0;) {
+        const auto& level = tree[l];
+        std::vector<BigUnsigned> next (level.size());
+        for (std::size_t i = 0; i < level.size(); i++) {
+            next[i] = rem[i / 2] % (level[i] * level[i]);
+        }
+        rem = std::move(next);
+    }
+    std::vector<BigUnsigned> res (N.size());
+    for (std::size_t i = 0; i < N.size(); i++) {
+        assert(!N[i].IsZero());
+        res[i] = Euclid(rem[i] / N[i], N[i]);
+    }
+    return res;
+}
+
+std::vector<u64> BatchGCD(const std::vector<u64>& N) {
+    auto res = BatchGCD(std::vector<BigUnsigned>(N.begin(), N.end()));
+    std::vector<u64> g (res.size());
+    for (std::size_t i = 0; i < res.size(); i++) {
+        g[i] = res[i].ToU64();
+    }
+    return g;
+}
+
+u64 MulMod(u64 a, u64 b, u64 n) {
+    return static_cast<u64>(static_cast<u128>(a) * b % n);
+}
+
+bool IsPrime(u64 n) {
+    if (n < 4) {
+        return n >= 2;
+    }
+    if (!(n & 1)) {
+        return false;
+    }
+    u64 u = n - 1;
+    const auto t = std::countr_zero(u);
+    u >>= t;
+    for (u64 a : {2, 325, 9375, 28178, 450775, 9780504, 1795265022}) {
+        a %= n;
+        if (!a) {
+            continue;
+        }
+        u64 x = 1;
+        for (u64 b = u, s = a; b; b >>= 1, s = MulMod(s, s, n)) {
+            if (b & 1) {
+                x = MulMod(x, s, n);
+            }
+        }
+        if (x == 1 || x == n - 1) {
+            continue;
+        }
+        bool composite = true;
+        for (int i = 1; i < t && composite; i++) {
+            x = MulMod(x, x, n);
+            composite = x != n - 1;
+        }
+        if (composite) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    std::vector<u64> small {6, 35, 143, 77, 17};
+    for (auto g : BatchGCD(small)) {
+        std::cout << g << ' ';
+    }
+    std::cout << '\n';
+
+    std::mt19937_64 gen(std::random_device{}());
+    for (std::size_t iter = 0; iter < 100; iter++) {
+        BigUnsigned a (std::vector<u32>(1 + gen() % 400));
+        BigUnsigned b (std::vector<u32>(1 + gen() % 200));
+        for (auto& l : a.limbs) {
+            l = static_cast<u32>(gen());
+        }
+        for (auto& l : b.limbs) {
+            l = static_cast<u32>(gen());
+        }
+        a.Trim();
+        b.Trim();
+        if (b.IsZero()) {
+            continue;
+        }
+        assert(a * b == SchoolbookMultiply(a, b));
+        auto [q, r] = DivMod(a, b);
+        assert(r < b && q * b + r == a);
+        assert(DivMod(a, b) == KnuthDivMod(a, b));
+    }
+
+    // 512-bit moduli, each the product of eight 64-bit primes; a few primes are reused
+    auto random_prime = [&gen]() {
+        u64 p = gen() | (u64 {1} << 63) | 1;
+        while (!IsPrime(p)) {
+            p += 2;
+        }
+        return p;
+    };
+    constexpr std::size_t N = 2'000;
+    std::vector<BigUnsigned> moduli (N, BigUnsigned(1));
+    std::vector<u64> shared {random_prime(), random_prime(), random_prime()};
+    for (std::size_t i = 0; i < N; i++) {
+        for (std::size_t j = 0; j < 8; j++) {
+            moduli[i] = moduli[i] * random_prime();
+        }
+    }
+    moduli[3] = moduli[3] * shared[0];
+    moduli[1000] = moduli[1000] * shared[0];
+    moduli[42] = moduli[42] * shared[1];
+    moduli[1999] = moduli[1999] * shared[1] * shared[2];
+    moduli[7] = moduli[7] * shared[2];
+
+    auto t1 = crn::steady_clock::now();
+    auto g = BatchGCD(moduli);
+    auto t2 = crn::steady_clock::now();
+    for (std::size_t i = 0; i < N; i++) {
+        if (g[i] != BigUnsigned(1)) {
+            std::cout << "modulus " << i << " shares factor " << g[i].ToString() << '\n';
+        }
+    }
+    std::size_t pairs = 0;
+    for (std::size_t i = 0; i < 200; i++) {
+        for (std::size_t j = i + 1; j < N; j++) {
+            if (Euclid(moduli[i], moduli[j]) != BigUnsigned(1)) {
+                pairs++;
+            }
+        }
+    }
+    auto t3 = crn::steady_clock::now();
+    assert(pairs == 3);
+    std::cout << "Batch gcd over " << N << " moduli : " << crn::duration_cast<crn::milliseconds>(t2 - t1).count() << "ms\n";
+    std::cout << "Pairwise gcd, first 200 rows only : " << crn::duration_cast<crn::milliseconds>(t3 - t2).count() << "ms\n";
+}
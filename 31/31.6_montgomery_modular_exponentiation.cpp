@@ -0,0 +1,262 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <bitset>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace crn = std::chrono;
+
+using u64 = std::uint64_t;
+using u128 = unsigned __int128;
+
+// textbook version, kept for comparison. d * d overflows when n >= 2^32.
+std::size_t ModularExponentiation(std::size_t a, std::size_t b, std::size_t n) {
+    assert(n);
+    std::size_t c = 0;
+    std::size_t d = 1;
+    auto k = std::bit_width(b);
+    std::bitset<64> B(b);
+    for (std::size_t i = k - 1; i < k; i--) {
+        c *= 2;
+        d = (d * d) % n;
+        if (B[i]) {
+            c++;
+            d = (d * a) % n;
+        }
+    }
+    return d;
+}
+
+u64 MulMod(u64 a, u64 b, u64 n) {
+    return static_cast<u64>(static_cast<u128>(a) * b % n);
+}
+
+// window width for sliding window / k-ary exponentiation, by exponent bit length
+std::size_t WindowSize(std::size_t bits) {
+    if (bits <= 8) {
+        return 1;
+    } else if (bits <= 24) {
+        return 2;
+    } else if (bits <= 80) {
+        return 3;
+    } else if (bits <= 240) {
+        return 4;
+    }
+    return 5;
+}
+
+class Montgomery {
+    u64 n = 0;
+    u64 n_inv = 0; // n^(-1) mod 2^64
+    u64 r1 = 0; // R mod n
+    u64 r2 = 0; // R^2 mod n
+
+public:
+    explicit Montgomery(u64 n) : n {n} {
+        assert(n & 1);
+        // Newton iteration, each step doubles the number of correct low bits
+        n_inv = n;
+        for (std::size_t i = 0; i < 5; i++) {
+            n_inv *= 2 - n * n_inv;
+        }
+        r1 = static_cast<u64>((static_cast<u128>(1) << 64) % n);
+        r2 = static_cast<u64>(static_cast<u128>(r1) * r1 % n);
+    }
+
+    [[nodiscard]] u64 Modulus() const {
+        return n;
+    }
+
+    // t < n * 2^64, returns t * 2^(-64) mod n in [0, n)
+    [[nodiscard]] u64 Reduce(u128 t) const {
+        u64 m = static_cast<u64>(t) * n_inv;
+        u64 mn_hi = static_cast<u64>((static_cast<u128>(m) * n) >> 64);
+        u64 t_hi = static_cast<u64>(t >> 64);
+        u64 res = t_hi - mn_hi;
+        return t_hi < mn_hi ? res + n : res;
+    }
+
+    [[nodiscard]] u64 Multiply(u64 a, u64 b) const {
+        return Reduce(static_cast<u128>(a) * b);
+    }
+
+    [[nodiscard]] u64 ToMontgomery(u64 a) const {
+        return Multiply(a % n, r2);
+    }
+
+    [[nodiscard]] u64 FromMontgomery(u64 a) const {
+        return Reduce(a);
+    }
+
+    [[nodiscard]] u64 One() const {
+        return r1;
+    }
+
+    // a and the result are in Montgomery form. sliding window over the bits of b.
+    [[nodiscard]] u64 Power(u64 a, u64 b) const {
+        if (!b) {
+            return r1;
+        }
+        const std::size_t bits = std::bit_width(b);
+        const std::size_t k = WindowSize(bits);
+        // odd powers a^1, a^3, ..., a^(2^k - 1)
+        std::array<u64, 16> odd {};
+        odd[0] = a;
+        u64 a2 = Multiply(a, a);
+        for (std::size_t j = 1; j < (std::size_t {1} << (k - 1)); j++) {
+            odd[j] = Multiply(odd[j - 1], a2);
+        }
+        u64 d = r1;
+        std::size_t i = bits - 1;
+        while (i < bits) {
+            if (!((b >> i) & 1)) {
+                d = Multiply(d, d);
+                i--;
+                continue;
+            }
+            // longest window [l, i] of width <= k ending in a set bit
+            std::size_t l = (i + 1 >= k) ? i + 1 - k : 0;
+            while (!((b >> l) & 1)) {
+                l++;
+            }
+            const std::size_t width = i - l + 1;
+            for (std::size_t j = 0; j < width; j++) {
+                d = Multiply(d, d);
+            }
+            u64 w = (b >> l) & ((u64 {1} << width) - 1);
+            d = Multiply(d, odd[w >> 1]);
+            i = l - 1;
+        }
+        return d;
+    }
+};
+
+// overflow-free a^b mod n for any n; Montgomery for odd n, plain 128-bit remainders otherwise.
+u64 MontgomeryExponentiation(u64 a, u64 b, u64 n) {
+    assert(n);
+    if (n == 1) {
+        return 0;
+    }
+    if (n & 1) {
+        Montgomery mont(n);
+        return mont.FromMontgomery(mont.Power(mont.ToMontgomery(a), b));
+    }
+    u64 d = 1;
+    a %= n;
+    for (std::size_t i = std::bit_width(b) - 1; i < 64; i--) {
+        d = MulMod(d, d, n);
+        if ((b >> i) & 1) {
+            d = MulMod(d, a, n);
+        }
+    }
+    return d;
+}
+
+// a_i^b mod n for every base a_i. the exponent is shared, so all bases go through the same
+// k-ary digit sequence and are processed in lanes of independent multiplication chains.
+// there is no 64x64->128 vector multiply on common targets, so the lanes are plain loops
+// that keep several multipliers busy at once instead of one serial chain per base.
+std::vector<u64> BatchModularExponentiation(const std::vector<u64>& A, u64 b, u64 n) {
+    assert(n);
+    std::vector<u64> res (A.size());
+    if (n == 1) {
+        return res;
+    }
+    if (!(n & 1)) {
+        for (std::size_t i = 0; i < A.size(); i++) {
+            res[i] = MontgomeryExponentiation(A[i], b, n);
+        }
+        return res;
+    }
+    Montgomery mont(n);
+    if (!b) {
+        for (auto& r : res) {
+            r = 1;
+        }
+        return res;
+    }
+    constexpr std::size_t lanes = 8;
+    const std::size_t bits = std::bit_width(b);
+    const std::size_t k = std::min<std::size_t>(WindowSize(bits), 4);
+    const std::size_t table_size = std::size_t {1} << k;
+    const std::size_t digits = (bits + k - 1) / k;
+
+    std::vector<u64> table (lanes * table_size);
+    std::array<u64, lanes> d {};
+    for (std::size_t base = 0; base < A.size(); base += lanes) {
+        const std::size_t cnt = std::min(lanes, A.size() - base);
+        // table[w * lanes + j] = a_j^w
+        for (std::size_t j = 0; j < lanes; j++) {
+            table[j] = mont.One();
+            table[lanes + j] = mont.ToMontgomery(j < cnt ? A[base + j] : 0);
+        }
+        for (std::size_t w = 2; w < table_size; w++) {
+            for (std::size_t j = 0; j < lanes; j++) {
+                table[w * lanes + j] = mont.Multiply(table[(w - 1) * lanes + j], table[lanes + j]);
+            }
+        }
+        for (std::size_t j = 0; j < lanes; j++) {
+            d[j] = mont.One();
+        }
+        for (std::size_t t = digits - 1; t < digits; t--) {
+            for (std::size_t s = 0; s < k; s++) {
+                for (std::size_t j = 0; j < lanes; j++) {
+                    d[j] = mont.Multiply(d[j], d[j]);
+                }
+            }
+            const std::size_t w = (b >> (t * k)) & (table_size - 1);
+            if (w) {
+                for (std::size_t j = 0; j < lanes; j++) {
+                    d[j] = mont.Multiply(d[j], table[w * lanes + j]);
+                }
+            }
+        }
+        for (std::size_t j = 0; j < cnt; j++) {
+            res[base + j] = mont.FromMontgomery(d[j]);
+        }
+    }
+    return res;
+}
+
+int main() {
+    std::cout << ModularExponentiation(7, 560, 561) << ' ' << MontgomeryExponentiation(7, 560, 561) << '\n';
+
+    std::mt19937_64 gen(std::random_device{}());
+    std::uniform_int_distribution<u64> small_dist(1, (1u << 31) - 1);
+    for (std::size_t i = 0; i < 10'000; i++) {
+        u64 a = small_dist(gen);
+        u64 b = small_dist(gen);
+        u64 n = small_dist(gen);
+        assert(ModularExponentiation(a, b, n) == MontgomeryExponentiation(a, b, n));
+    }
+    // 2^64 - 59 is prime, Fermat's little theorem
+    constexpr u64 p = 18446744073709551557ull;
+    std::uniform_int_distribution<u64> dist(2, p - 1);
+    for (std::size_t i = 0; i < 1'000; i++) {
+        assert(MontgomeryExponentiation(dist(gen), p - 1, p) == 1);
+    }
+
+    constexpr std::size_t N = 100'000;
+    std::vector<u64> A (N);
+    for (auto& a : A) {
+        a = dist(gen);
+    }
+    const u64 e = dist(gen);
+    std::vector<u64> R1 (N);
+    auto t1 = crn::steady_clock::now();
+    for (std::size_t i = 0; i < N; i++) {
+        R1[i] = MontgomeryExponentiation(A[i], e, p);
+    }
+    auto t2 = crn::steady_clock::now();
+    auto R2 = BatchModularExponentiation(A, e, p);
+    auto t3 = crn::steady_clock::now();
+    assert(R1 == R2);
+    std::cout << "Montgomery, sliding window : " << crn::duration_cast<crn::microseconds>(t2 - t1).count() << "us\n";
+    std::cout << "Montgomery, batched k-ary : " << crn::duration_cast<crn::microseconds>(t3 - t2).count() << "us\n";
+}
@@ -0,0 +1,307 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <bitset>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <ranges>
+#include <vector>
+
+namespace crn = std::chrono;
+namespace sr = std::ranges;
+
+using u64 = std::uint64_t;
+using u128 = unsigned __int128;
+
+std::size_t ModularExponentiation(std::size_t a, std::size_t b, std::size_t n) {
+    assert(n);
+    std::size_t c = 0;
+    std::size_t d = 1;
+    auto k = std::bit_width(b);
+    std::bitset<64> B(b);
+    for (std::size_t i = k - 1; i < k; i--) {
+        c *= 2;
+        d = (d * d) % n;
+        if (B[i]) {
+            c++;
+            d = (d * a) % n;
+        }
+    }
+    return d;
+}
+
+enum class NumberClass {
+    Composite,
+    Prime,
+};
+
+bool Witness(std::size_t a, std::size_t n) {
+    std::size_t t = 0;
+    std::size_t u = n - 1;
+    while ((u % 2) == 0) {
+        t++;
+        u /= 2;
+    }
+    std::vector<std::size_t> X (t + 1);
+    X[0] = ModularExponentiation(a, u, n);
+    for (std::size_t i = 1; i <= t; i++) {
+        X[i] = (X[i - 1] * X[i - 1]) % n;
+        if (X[i] == 1 && X[i - 1] != 1 && X[i - 1] != n - 1) {
+            return true;
+        }
+    }
+    if (X[t] != 1) {
+        return true;
+    }
+    return false;
+}
+
+std::mt19937 gen(std::random_device{}());
+
+NumberClass MillerRabin(std::size_t n, std::size_t s) {
+    std::uniform_int_distribution<> dist(1, n - 1);
+    for (std::size_t j = 1; j <= s; j++) {
+        std::size_t a = dist(gen);
+        if (Witness(a, n)) {
+            return NumberClass::Composite;
+        }
+    }
+    return NumberClass::Prime;
+}
+
+class Montgomery {
+    u64 n = 0;
+    u64 n_inv = 0; // n^(-1) mod 2^64
+    u64 r1 = 0; // R mod n
+    u64 r2 = 0; // R^2 mod n
+
+public:
+    explicit Montgomery(u64 n) : n {n} {
+        assert(n & 1);
+        n_inv = n;
+        for (std::size_t i = 0; i < 5; i++) {
+            n_inv *= 2 - n * n_inv;
+        }
+        r1 = static_cast<u64>((static_cast<u128>(1) << 64) % n);
+        r2 = static_cast<u64>(static_cast<u128>(r1) * r1 % n);
+    }
+
+    [[nodiscard]] u64 Reduce(u128 t) const {
+        u64 m = static_cast<u64>(t) * n_inv;
+        u64 mn_hi = static_cast<u64>((static_cast<u128>(m) * n) >> 64);
+        u64 t_hi = static_cast<u64>(t >> 64);
+        u64 res = t_hi - mn_hi;
+        return t_hi < mn_hi ? res + n : res;
+    }
+
+    [[nodiscard]] u64 Multiply(u64 a, u64 b) const {
+        return Reduce(static_cast<u128>(a) * b);
+    }
+
+    [[nodiscard]] u64 ToMontgomery(u64 a) const {
+        return Multiply(a % n, r2);
+    }
+
+    [[nodiscard]] u64 One() const {
+        return r1;
+    }
+
+    [[nodiscard]] u64 Power(u64 a, u64 b) const {
+        u64 d = r1;
+        while (b) {
+            if (b & 1) {
+                d = Multiply(d, a);
+            }
+            a = Multiply(a, a);
+            b >>= 1;
+        }
+        return d;
+    }
+};
+
+// Sinclair's base set, no strong pseudoprime to all of them below 2^64
+constexpr std::array<u64, 7> deterministic_bases = {2, 325, 9375, 28178, 450775, 9780504, 1795265022};
+
+constexpr std::array<u64, 15> small_primes = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47};
+
+// residues mod 2 * 3 * 5 * 7 = 210 that are coprime to 210
+constexpr std::array<bool, 210> ComputeWheel() {
+    std::array<bool, 210> wheel {};
+    for (std::size_t r = 0; r < 210; r++) {
+        wheel[r] = (r % 2) && (r % 3) && (r % 5) && (r % 7);
+    }
+    return wheel;
+}
+
+constexpr auto wheel210 = ComputeWheel();
+
+// n odd, n > 2. a is assumed to be reduced already
+bool StrongWitness(const Montgomery& mont, u64 a, u64 n) {
+    u64 u = n - 1;
+    const auto t = std::countr_zero(u);
+    u >>= t;
+    const u64 one = mont.One();
+    const u64 minus_one = n - one; // -1 in Montgomery form
+    u64 x = mont.Power(mont.ToMontgomery(a), u);
+    if (x == one || x == minus_one) {
+        return false;
+    }
+    for (int i = 1; i < t; i++) {
+        x = mont.Multiply(x, x);
+        if (x == minus_one) {
+            return false;
+        }
+        if (x == one) {
+            return true;
+        }
+    }
+    return true;
+}
+
+NumberClass DeterministicMillerRabin(u64 n) {
+    if (n < 2) {
+        return NumberClass::Composite;
+    }
+    if (n <= small_primes.back()) {
+        return sr::binary_search(small_primes, n) ? NumberClass::Prime : NumberClass::Composite;
+    }
+    if (!wheel210[n % 210]) {
+        return NumberClass::Composite;
+    }
+    for (std::size_t i = 4; i < small_primes.size(); i++) {
+        if (n % small_primes[i] == 0) {
+            return NumberClass::Composite;
+        }
+    }
+    if (n < 47 * 47) {
+        return NumberClass::Prime;
+    }
+    Montgomery mont(n);
+    for (auto base : deterministic_bases) {
+        u64 a = base % n;
+        if (a && StrongWitness(mont, a, n)) {
+            return NumberClass::Composite;
+        }
+    }
+    return NumberClass::Prime;
+}
+
+std::vector<NumberClass> BatchPrimality(const std::vector<u64>& candidates) {
+    std::vector<NumberClass> res (candidates.size());
+    for (std::size_t i = 0; i < candidates.size(); i++) {
+        res[i] = DeterministicMillerRabin(candidates[i]);
+    }
+    return res;
+}
+
+std::vector<u64> SievePrimes(u64 limit) {
+    std::vector<bool> composite (limit + 1);
+    std::vector<u64> primes;
+    for (u64 i = 2; i <= limit; i++) {
+        if (!composite[i]) {
+            primes.push_back(i);
+            for (u64 j = i * i; j <= limit; j += i) {
+                composite[j] = true;
+            }
+        }
+    }
+    return primes;
+}
+
+// all primes in [lo, hi). each segment of odd numbers is a bit array sieved by primes up to
+// sieve_limit; survivors are primes if sieve_limit^2 covers the segment,
+// otherwise they go through the deterministic test.
+std::vector<u64> PrimesInRange(u64 lo, u64 hi, u64 sieve_limit = 1u << 16) {
+    std::vector<u64> res;
+    if (hi <= lo) {
+        return res;
+    }
+    if (lo <= 2 && 2 < hi) {
+        res.push_back(2);
+    }
+    u64 base = std::max<u64>(lo, 3) | 1;
+    if (base >= hi) {
+        return res;
+    }
+    const auto primes = SievePrimes(sieve_limit);
+    const u64 sieve_limit_sq = sieve_limit * sieve_limit;
+
+    constexpr u64 segment_bits = u64 {1} << 18; // 32 KiB of odd numbers per segment
+    std::vector<u64> segment (segment_bits / 64);
+    while (base < hi) {
+        const u64 count = std::min(segment_bits, (hi - base + 1) / 2);
+        const u64 seg_end = base + 2 * count; // one past the last odd number of the segment
+        std::fill(segment.begin(), segment.end(), 0);
+        for (std::size_t k = 1; k < primes.size(); k++) {
+            const u64 p = primes[k];
+            if (p * p >= seg_end) {
+                break;
+            }
+            u64 start = std::max(p * p, (base + p - 1) / p * p);
+            if (!(start & 1)) {
+                start += p;
+            }
+            for (u64 i = (start - base) / 2; i < count; i += p) {
+                segment[i / 64] |= u64 {1} << (i % 64);
+            }
+        }
+        const bool needs_test = seg_end - 2 >= sieve_limit_sq;
+        for (u64 w = 0; w * 64 < count; w++) {
+            u64 alive = ~segment[w];
+            if ((w + 1) * 64 > count) {
+                alive &= (u64 {1} << (count - w * 64)) - 1;
+            }
+            while (alive) {
+                const u64 n = base + 2 * (w * 64 + std::countr_zero(alive));
+                alive &= alive - 1;
+                if (n == 1) {
+                    continue;
+                }
+                if (!needs_test || n < sieve_limit_sq || DeterministicMillerRabin(n) == NumberClass::Prime) {
+                    res.push_back(n);
+                }
+            }
+        }
+        base = seg_end;
+    }
+    return res;
+}
+
+int main() {
+    for (u64 n = 3; n < 100'000; n += 2) {
+        bool p1 = MillerRabin(n, 20) == NumberClass::Prime;
+        bool p2 = DeterministicMillerRabin(n) == NumberClass::Prime;
+        assert(p1 == p2);
+    }
+    // strong pseudoprimes to bases 2, 3, 5, 7, 11, 13 and 17
+    assert(DeterministicMillerRabin(341'550'071'728'321ull) == NumberClass::Composite);
+    assert(DeterministicMillerRabin(3'825'123'056'546'413'051ull) == NumberClass::Composite);
+    assert(DeterministicMillerRabin(18'446'744'073'709'551'557ull) == NumberClass::Prime);
+    assert(DeterministicMillerRabin(4'294'967'291ull * 4'294'967'279ull) == NumberClass::Composite);
+
+    auto small = PrimesInRange(0, 1'000'000);
+    assert(small == SievePrimes(999'999));
+    std::cout << small.size() << " primes below 10^6\n";
+
+    constexpr u64 lo = 1'000'000'000'000'000'000ull;
+    constexpr u64 width = 10'000'000;
+    auto t1 = crn::steady_clock::now();
+    auto primes = PrimesInRange(lo, lo + width);
+    auto t2 = crn::steady_clock::now();
+    std::size_t count = 0;
+    for (u64 n = lo + 1; n < lo + width; n += 2) {
+        if (DeterministicMillerRabin(n) == NumberClass::Prime) {
+            count++;
+        }
+    }
+    auto t3 = crn::steady_clock::now();
+    assert(count == primes.size());
+    std::cout << primes.size() << " primes in [10^18, 10^18 + 10^7)\n";
+    std::cout << "Segmented sieve + Miller-Rabin : " << crn::duration_cast<crn::milliseconds>(t2 - t1).count() << "ms\n";
+    std::cout << "Per-number Miller-Rabin : " << crn::duration_cast<crn::milliseconds>(t3 - t2).count() << "ms\n";
+}
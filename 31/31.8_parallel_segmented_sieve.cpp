@@ -0,0 +1,279 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace crn = std::chrono;
+
+using u64 = std::uint64_t;
+
+// wheel of 2 * 3 * 5 * 7: each block of 210 integers has 48 residues coprime to 210,
+// stored as the low 48 bits of one word.
+constexpr u64 wheel = 210;
+constexpr std::size_t wheel_residues = 48;
+constexpr u64 block_mask = (u64 {1} << wheel_residues) - 1;
+
+struct WheelTables {
+    std::array<std::uint8_t, wheel_residues> residues {};
+    std::array<std::uint8_t, wheel_residues> gaps {}; // residues[i + 1] - residues[i], cyclic
+    std::array<std::uint8_t, wheel> index {}; // bit of residue r, or 0xFF if r is not coprime
+    std::array<std::uint8_t, wheel> up {}; // distance from r to the next coprime residue >= r
+};
+
+constexpr WheelTables ComputeWheelTables() {
+    WheelTables t;
+    std::size_t k = 0;
+    for (std::size_t r = 0; r < wheel; r++) {
+        t.index[r] = 0xFF;
+        if ((r % 2) && (r % 3) && (r % 5) && (r % 7)) {
+            t.index[r] = static_cast<std::uint8_t>(k);
+            t.residues[k++] = static_cast<std::uint8_t>(r);
+        }
+    }
+    for (std::size_t i = 0; i < wheel_residues; i++) {
+        std::size_t next = (i + 1 == wheel_residues) ? t.residues[0] + wheel : t.residues[i + 1];
+        t.gaps[i] = static_cast<std::uint8_t>(next - t.residues[i]);
+    }
+    for (std::size_t r = wheel; r-- > 0;) {
+        t.up[r] = (t.index[r] != 0xFF) ? 0 : static_cast<std::uint8_t>(t.up[r + 1] + 1);
+    }
+    return t;
+}
+
+constexpr auto wheel_tables = ComputeWheelTables();
+
+// 32768 blocks = 256 KiB of words, about 6.9 * 10^6 integers per segment
+constexpr u64 segment_blocks = u64 {1} << 15;
+
+u64 ISqrt(u64 n) {
+    auto r = static_cast<u64>(std::sqrt(static_cast<double>(n)));
+    while (r * r > n) {
+        r--;
+    }
+    while ((r + 1) * (r + 1) <= n) {
+        r++;
+    }
+    return r;
+}
+
+// odd primes up to limit, by the classic sieve. limit is at most sqrt(hi), so this is small.
+std::vector<u64> SievingPrimes(u64 limit) {
+    std::vector<bool> composite (limit + 1);
+    std::vector<u64> primes;
+    for (u64 i = 3; i <= limit; i += 2) {
+        if (!composite[i]) {
+            primes.push_back(i);
+            for (u64 j = i * i; j <= limit; j += 2 * i) {
+                composite[j] = true;
+            }
+        }
+    }
+    return primes;
+}
+
+// sieves blocks [first_block, first_block + num_blocks). afterwards a bit is set iff the
+// corresponding integer has no prime factor below its square root (1 is still set).
+void SieveSegment(u64 first_block, u64 num_blocks, const std::vector<u64>& primes, std::vector<u64>& bits) {
+    std::fill(bits.begin(), bits.begin() + num_blocks, block_mask);
+    const u64 seg_lo = first_block * wheel;
+    const u64 seg_hi = seg_lo + num_blocks * wheel;
+    for (auto p : primes) {
+        if (p < 11) {
+            continue;
+        }
+        if (p * p >= seg_hi) {
+            break;
+        }
+        // multiples p * q with q coprime to 210 and q >= p, enumerated along the wheel
+        u64 q = std::max(p, (seg_lo + p - 1) / p);
+        q += wheel_tables.up[q % wheel];
+        std::size_t wi = wheel_tables.index[q % wheel];
+        for (u64 n = p * q; n < seg_hi; n = p * q) {
+            const u64 off = n - seg_lo;
+            bits[off / wheel] &= ~(u64 {1} << wheel_tables.index[off % wheel]);
+            q += wheel_tables.gaps[wi];
+            wi = (wi + 1 == wheel_residues) ? 0 : wi + 1;
+        }
+    }
+}
+
+// bits of block b that lie in [lo, hi), excluding 1
+u64 RangeMask(u64 b, u64 lo, u64 hi) {
+    const u64 base = b * wheel;
+    if (base >= lo && base + wheel <= hi && b) {
+        return block_mask;
+    }
+    u64 mask = 0;
+    for (std::size_t i = 0; i < wheel_residues; i++) {
+        const u64 n = base + wheel_tables.residues[i];
+        if (n >= lo && n < hi && n != 1) {
+            mask |= u64 {1} << i;
+        }
+    }
+    return mask;
+}
+
+u64 CountWheelPrimes(u64 lo, u64 hi) {
+    u64 count = 0;
+    for (u64 p : {2, 3, 5, 7}) {
+        if (lo <= p && p < hi) {
+            count++;
+        }
+    }
+    return count;
+}
+
+// number of primes in [lo, hi). threads grab segments from a shared counter, so memory stays
+// at one segment per thread regardless of the range.
+u64 CountPrimes(u64 lo, u64 hi, std::size_t num_threads = std::thread::hardware_concurrency()) {
+    if (hi <= lo) {
+        return 0;
+    }
+    assert(hi <= (u64 {1} << 62));
+    num_threads = std::max<std::size_t>(num_threads, 1);
+    const auto primes = SievingPrimes(ISqrt(hi - 1));
+    const u64 first_block = lo / wheel;
+    const u64 last_block = (hi - 1) / wheel + 1;
+    const u64 num_segments = (last_block - first_block + segment_blocks - 1) / segment_blocks;
+
+    std::atomic<u64> next_segment = 0;
+    std::vector<u64> counts (num_threads);
+    auto worker = [&](std::size_t t) {
+        std::vector<u64> bits (segment_blocks);
+        u64 count = 0;
+        for (u64 s = next_segment++; s < num_segments; s = next_segment++) {
+            const u64 b0 = first_block + s * segment_blocks;
+            const u64 nb = std::min(segment_blocks, last_block - b0);
+            SieveSegment(b0, nb, primes, bits);
+            for (u64 i = 0; i < nb; i++) {
+                u64 w = bits[i];
+                if (i == 0 || i + 1 == nb) {
+                    w &= RangeMask(b0 + i, lo, hi);
+                }
+                count += std::popcount(w);
+            }
+        }
+        counts[t] = count;
+    };
+    {
+        std::vector<std::jthread> threads;
+        for (std::size_t t = 1; t < num_threads; t++) {
+            threads.emplace_back(worker, t);
+        }
+        worker(0);
+    }
+    u64 total = CountWheelPrimes(lo, hi);
+    for (auto c : counts) {
+        total += c;
+    }
+    return total;
+}
+
+// calls f(p) for every prime p in [lo, hi) in increasing order. each round sieves
+// num_threads consecutive segments in parallel, then streams them in order.
+void ForEachPrime(u64 lo, u64 hi, const std::function<void(u64)>& f,
+                  std::size_t num_threads = std::thread::hardware_concurrency()) {
+    if (hi <= lo) {
+        return;
+    }
+    assert(hi <= (u64 {1} << 62));
+    num_threads = std::max<std::size_t>(num_threads, 1);
+    for (u64 p : {2, 3, 5, 7}) {
+        if (lo <= p && p < hi) {
+            f(p);
+        }
+    }
+    const auto primes = SievingPrimes(ISqrt(hi - 1));
+    const u64 first_block = lo / wheel;
+    const u64 last_block = (hi - 1) / wheel + 1;
+    std::vector<std::vector<u64>> buffers (num_threads, std::vector<u64>(segment_blocks));
+
+    for (u64 b = first_block; b < last_block; b += num_threads * segment_blocks) {
+        auto sieve = [&](std::size_t t) {
+            const u64 b0 = b + t * segment_blocks;
+            if (b0 < last_block) {
+                SieveSegment(b0, std::min(segment_blocks, last_block - b0), primes, buffers[t]);
+            }
+        };
+        {
+            std::vector<std::jthread> threads;
+            for (std::size_t t = 1; t < num_threads; t++) {
+                threads.emplace_back(sieve, t);
+            }
+            sieve(0);
+        }
+        for (std::size_t t = 0; t < num_threads; t++) {
+            const u64 b0 = b + t * segment_blocks;
+            if (b0 >= last_block) {
+                break;
+            }
+            const u64 nb = std::min(segment_blocks, last_block - b0);
+            for (u64 i = 0; i < nb; i++) {
+                u64 w = buffers[t][i];
+                if (i == 0 || i + 1 == nb) {
+                    w &= RangeMask(b0 + i, lo, hi);
+                }
+                while (w) {
+                    f((b0 + i) * wheel + wheel_tables.residues[std::countr_zero(w)]);
+                    w &= w - 1;
+                }
+            }
+        }
+    }
+}
+
+// all primes in [lo, hi), e.g. trial divisors for PollardRho or the primality prefilter
+std::vector<u64> GeneratePrimes(u64 lo, u64 hi, std::size_t num_threads = std::thread::hardware_concurrency()) {
+    std::vector<u64> res;
+    ForEachPrime(lo, hi, [&res](u64 p) { res.push_back(p); }, num_threads);
+    return res;
+}
+
+int main() {
+    // compare against the plain sieve
+    constexpr u64 N = 1'000'000;
+    auto odd = SievingPrimes(N);
+    std::vector<u64> expected {2};
+    expected.insert(expected.end(), odd.begin(), odd.end());
+    assert(GeneratePrimes(0, N + 1) == expected);
+    for (u64 lo : std::initializer_list<u64>{0, 1, 7, 11, 209, 211, 12345}) {
+        for (u64 hi : std::initializer_list<u64>{lo, lo + 1, lo + 210, 99'991, 100'000}) {
+            if (hi < lo) {
+                continue;
+            }
+            auto lo_it = std::lower_bound(expected.begin(), expected.end(), lo);
+            auto hi_it = std::lower_bound(expected.begin(), expected.end(), hi);
+            assert(CountPrimes(lo, hi, 3) == static_cast<u64>(hi_it - lo_it));
+        }
+    }
+
+    auto t1 = crn::steady_clock::now();
+    auto pi1 = CountPrimes(0, 1'000'000'000, 1);
+    auto t2 = crn::steady_clock::now();
+    auto pi2 = CountPrimes(0, 1'000'000'000);
+    auto t3 = crn::steady_clock::now();
+    assert(pi1 == 50'847'534 && pi2 == pi1);
+    std::cout << "pi(10^9) = " << pi1 << '\n';
+    std::cout << "1 thread : " << crn::duration_cast<crn::milliseconds>(t2 - t1).count() << "ms\n";
+    std::cout << std::thread::hardware_concurrency() << " threads : "
+              << crn::duration_cast<crn::milliseconds>(t3 - t2).count() << "ms\n";
+
+    u64 count = 0;
+    u64 last = 0;
+    ForEachPrime(1'000'000'000'000ull - 10'000'000, 1'000'000'000'000ull, [&](u64 p) {
+        assert(p > last);
+        last = p;
+        count++;
+    });
+    std::cout << count << " primes in [10^12 - 10^7, 10^12), largest " << last << '\n';
+}
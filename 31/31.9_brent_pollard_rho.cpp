@@ -0,0 +1,285 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <ranges>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace crn = std::chrono;
+namespace sr = std::ranges;
+
+using u64 = std::uint64_t;
+using u128 = unsigned __int128;
+
+class Montgomery {
+    u64 n = 0;
+    u64 n_inv = 0; // n^(-1) mod 2^64
+    u64 r1 = 0; // R mod n
+    u64 r2 = 0; // R^2 mod n
+
+public:
+    explicit Montgomery(u64 n) : n {n} {
+        assert(n & 1);
+        n_inv = n;
+        for (std::size_t i = 0; i < 5; i++) {
+            n_inv *= 2 - n * n_inv;
+        }
+        r1 = static_cast<u64>((static_cast<u128>(1) << 64) % n);
+        r2 = static_cast<u64>(static_cast<u128>(r1) * r1 % n);
+    }
+
+    [[nodiscard]] u64 Reduce(u128 t) const {
+        u64 m = static_cast<u64>(t) * n_inv;
+        u64 mn_hi = static_cast<u64>((static_cast<u128>(m) * n) >> 64);
+        u64 t_hi = static_cast<u64>(t >> 64);
+        u64 res = t_hi - mn_hi;
+        return t_hi < mn_hi ? res + n : res;
+    }
+
+    [[nodiscard]] u64 Multiply(u64 a, u64 b) const {
+        return Reduce(static_cast<u128>(a) * b);
+    }
+
+    [[nodiscard]] u64 Add(u64 a, u64 b) const {
+        return a >= n - b ? a - (n - b) : a + b;
+    }
+
+    [[nodiscard]] u64 ToMontgomery(u64 a) const {
+        return Multiply(a % n, r2);
+    }
+
+    [[nodiscard]] u64 One() const {
+        return r1;
+    }
+
+    [[nodiscard]] u64 Power(u64 a, u64 b) const {
+        u64 d = r1;
+        while (b) {
+            if (b & 1) {
+                d = Multiply(d, a);
+            }
+            a = Multiply(a, a);
+            b >>= 1;
+        }
+        return d;
+    }
+};
+
+// Sinclair's base set, no strong pseudoprime to all of them below 2^64. n odd, n > 1.
+bool IsPrimeOdd(u64 n) {
+    constexpr std::array<u64, 7> bases = {2, 325, 9375, 28178, 450775, 9780504, 1795265022};
+    Montgomery mont(n);
+    u64 u = n - 1;
+    const auto t = std::countr_zero(u);
+    u >>= t;
+    const u64 one = mont.One();
+    const u64 minus_one = n - one;
+    for (auto base : bases) {
+        u64 a = base % n;
+        if (!a) {
+            continue;
+        }
+        u64 x = mont.Power(mont.ToMontgomery(a), u);
+        if (x == one || x == minus_one) {
+            continue;
+        }
+        bool composite = true;
+        for (int i = 1; i < t && composite; i++) {
+            x = mont.Multiply(x, x);
+            if (x == minus_one) {
+                composite = false;
+            } else if (x == one) {
+                break;
+            }
+        }
+        if (composite) {
+            return false;
+        }
+    }
+    return true;
+}
+
+constexpr u64 trial_limit = 1024;
+
+std::vector<u64> TrialPrimes() {
+    std::vector<bool> composite (trial_limit);
+    std::vector<u64> primes;
+    for (u64 i = 2; i < trial_limit; i++) {
+        if (!composite[i]) {
+            primes.push_back(i);
+            for (u64 j = i * i; j < trial_limit; j += i) {
+                composite[j] = true;
+            }
+        }
+    }
+    return primes;
+}
+
+const std::vector<u64> trial_primes = TrialPrimes();
+
+// Brent's cycle detection on x -> x^2 + c, all in Montgomery form. |x - y| is accumulated
+// over blocks of m steps so that one gcd covers m steps; if a block overshoots (gcd == n),
+// the block is replayed one step at a time. returns n on failure.
+u64 BrentRho(u64 n, u64 c, u64 x0) {
+    constexpr u64 m = 128;
+    Montgomery mont(n);
+    c = mont.ToMontgomery(c);
+    auto f = [&mont, c](u64 v) { return mont.Add(mont.Multiply(v, v), c); };
+    u64 y = mont.ToMontgomery(x0);
+    u64 x = y;
+    u64 ys = y;
+    u64 q = mont.One();
+    u64 g = 1;
+    for (u64 r = 1; g == 1; r *= 2) {
+        x = y;
+        for (u64 i = 0; i < r; i++) {
+            y = f(y);
+        }
+        for (u64 k = 0; k < r && g == 1; k += m) {
+            ys = y;
+            for (u64 i = 0; i < std::min(m, r - k); i++) {
+                y = f(y);
+                q = mont.Multiply(q, x > y ? x - y : y - x);
+            }
+            g = std::gcd(q, n);
+        }
+    }
+    if (g == n) {
+        do {
+            ys = f(ys);
+            g = std::gcd(x > ys ? x - ys : ys - x, n);
+        } while (g == 1);
+    }
+    return g;
+}
+
+// n odd, composite, without factors below trial_limit
+void FactorizeRec(u64 n, std::vector<u64>& factors) {
+    if (n == 1) {
+        return;
+    }
+    if (IsPrimeOdd(n)) {
+        factors.push_back(n);
+        return;
+    }
+    u64 d = n;
+    for (u64 c = 1; d == n; c++) {
+        d = BrentRho(n, c, 2);
+    }
+    FactorizeRec(d, factors);
+    FactorizeRec(n / d, factors);
+}
+
+// prime factorization of n as (prime, multiplicity), in increasing order of primes
+std::vector<std::pair<u64, std::size_t>> Factorize(u64 n) {
+    assert(n);
+    std::vector<u64> factors;
+    for (auto p : trial_primes) {
+        if (p * p > n) {
+            break;
+        }
+        while (n % p == 0) {
+            factors.push_back(p);
+            n /= p;
+        }
+    }
+    if (n < trial_limit * trial_limit) {
+        if (n > 1) {
+            factors.push_back(n);
+        }
+    } else {
+        FactorizeRec(n, factors);
+    }
+    sr::sort(factors);
+    std::vector<std::pair<u64, std::size_t>> res;
+    for (auto p : factors) {
+        if (!res.empty() && res.back().first == p) {
+            res.back().second++;
+        } else {
+            res.emplace_back(p, 1);
+        }
+    }
+    return res;
+}
+
+// factorizes every number, splitting the input into one contiguous range per thread
+std::vector<std::vector<std::pair<u64, std::size_t>>> FactorizeBatch(const std::vector<u64>& N,
+        std::size_t num_threads = std::thread::hardware_concurrency()) {
+    std::vector<std::vector<std::pair<u64, std::size_t>>> res (N.size());
+    num_threads = std::clamp<std::size_t>(num_threads, 1, std::max<std::size_t>(N.size(), 1));
+    const std::size_t chunk = (N.size() + num_threads - 1) / num_threads;
+    auto worker = [&](std::size_t t) {
+        for (std::size_t i = t * chunk; i < std::min(N.size(), (t + 1) * chunk); i++) {
+            res[i] = Factorize(N[i]);
+        }
+    };
+    {
+        std::vector<std::jthread> threads;
+        for (std::size_t t = 1; t < num_threads; t++) {
+            threads.emplace_back(worker, t);
+        }
+        worker(0);
+    }
+    return res;
+}
+
+bool Verify(u64 n, const std::vector<std::pair<u64, std::size_t>>& factors) {
+    u64 prod = 1;
+    for (auto [p, e] : factors) {
+        if (p < 2 || (p > 2 && !IsPrimeOdd(p))) {
+            return false;
+        }
+        for (std::size_t i = 0; i < e; i++) {
+            prod *= p;
+        }
+    }
+    return prod == n;
+}
+
+int main() {
+    for (auto [p, e] : Factorize(1328789)) {
+        std::cout << p << '^' << e << ' ';
+    }
+    std::cout << '\n';
+
+    for (u64 n = 1; n < 100'000; n++) {
+        assert(Verify(n, Factorize(n)));
+    }
+    // products of two primes around 2^32, the worst case for rho
+    const std::vector<u64> hard = {4'294'967'291ull * 4'294'967'279ull,
+                                   4'294'967'291ull * 4'294'967'291ull,
+                                   1'000'000'007ull * 998'244'353ull,
+                                   18'446'744'073'709'551'557ull,
+                                   (1ull << 63) + 1};
+    for (auto n : hard) {
+        auto factors = Factorize(n);
+        assert(Verify(n, factors));
+        std::cout << n << " =";
+        for (auto [p, e] : factors) {
+            std::cout << ' ' << p << '^' << e;
+        }
+        std::cout << '\n';
+    }
+
+    std::mt19937_64 gen(std::random_device{}());
+    std::vector<u64> N (100'000);
+    for (auto& n : N) {
+        n = gen() | 1;
+    }
+    auto t1 = crn::steady_clock::now();
+    auto res = FactorizeBatch(N);
+    auto t2 = crn::steady_clock::now();
+    for (std::size_t i = 0; i < N.size(); i++) {
+        assert(Verify(N[i], res[i]));
+    }
+    std::cout << "Factorized " << N.size() << " random 64-bit integers : "
+              << crn::duration_cast<crn::milliseconds>(t2 - t1).count() << "ms\n";
+}
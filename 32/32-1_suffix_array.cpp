@@ -0,0 +1,462 @@
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace crn = std::chrono;
+namespace fs = std::filesystem;
+
+// SA-IS (Nong, Zhang and Chan). s[i] in [0, upper]. suffixes are classified as S or L type,
+// the LMS substrings are sorted by induction, named, and sorted recursively when names repeat.
+std::vector<std::int32_t> SAIS(const std::vector<std::int32_t>& s, std::int32_t upper) {
+    const auto n = static_cast<std::int32_t>(s.size());
+    if (n == 0) {
+        return {};
+    }
+    if (n == 1) {
+        return {0};
+    }
+    if (n == 2) {
+        return s[0] < s[1] ? std::vector<std::int32_t>{0, 1} : std::vector<std::int32_t>{1, 0};
+    }
+    std::vector<std::int32_t> sa (n);
+    std::vector<std::uint8_t> is_s (n); // S-type suffixes
+    for (std::int32_t i = n - 2; i >= 0; i--) {
+        is_s[i] = (s[i] == s[i + 1]) ? is_s[i + 1] : (s[i] < s[i + 1]);
+    }
+    // bucket c holds L-type suffixes in [sum_l[c], sum_s[c]) and S-type ones in [sum_s[c], sum_l[c + 1])
+    std::vector<std::int32_t> sum_l (upper + 2);
+    std::vector<std::int32_t> sum_s (upper + 2);
+    for (std::int32_t i = 0; i < n; i++) {
+        if (!is_s[i]) {
+            sum_s[s[i]]++;
+        } else {
+            sum_l[s[i] + 1]++;
+        }
+    }
+    for (std::int32_t c = 0; c <= upper; c++) {
+        sum_s[c] += sum_l[c];
+        sum_l[c + 1] += sum_s[c];
+    }
+
+    auto induce = [&](const std::vector<std::int32_t>& lms) {
+        std::fill(sa.begin(), sa.end(), -1);
+        std::vector<std::int32_t> buf (upper + 2);
+        std::copy(sum_s.begin(), sum_s.end(), buf.begin());
+        for (auto d : lms) {
+            if (d != n) {
+                sa[buf[s[d]]++] = d;
+            }
+        }
+        std::copy(sum_l.begin(), sum_l.end(), buf.begin());
+        sa[buf[s[n - 1]]++] = n - 1;
+        for (std::int32_t i = 0; i < n; i++) {
+            auto v = sa[i];
+            if (v >= 1 && !is_s[v - 1]) {
+                sa[buf[s[v - 1]]++] = v - 1;
+            }
+        }
+        std::copy(sum_l.begin(), sum_l.end(), buf.begin());
+        for (std::int32_t i = n - 1; i >= 0; i--) {
+            auto v = sa[i];
+            if (v >= 1 && is_s[v - 1]) {
+                sa[--buf[s[v - 1] + 1]] = v - 1;
+            }
+        }
+    };
+
+    std::vector<std::int32_t> lms_map (n + 1, -1);
+    std::vector<std::int32_t> lms;
+    for (std::int32_t i = 1; i < n; i++) {
+        if (!is_s[i - 1] && is_s[i]) {
+            lms_map[i] = static_cast<std::int32_t>(lms.size());
+            lms.push_back(i);
+        }
+    }
+    const auto m = static_cast<std::int32_t>(lms.size());
+    induce(lms);
+    if (m) {
+        std::vector<std::int32_t> sorted_lms;
+        sorted_lms.reserve(m);
+        for (auto v : sa) {
+            if (lms_map[v] != -1) {
+                sorted_lms.push_back(v);
+            }
+        }
+        std::vector<std::int32_t> rec_s (m);
+        std::int32_t rec_upper = 0;
+        rec_s[lms_map[sorted_lms[0]]] = 0;
+        for (std::int32_t i = 1; i < m; i++) {
+            auto l = sorted_lms[i - 1];
+            auto r = sorted_lms[i];
+            auto end_l = (lms_map[l] + 1 < m) ? lms[lms_map[l] + 1] : n;
+            auto end_r = (lms_map[r] + 1 < m) ? lms[lms_map[r] + 1] : n;
+            bool same = true;
+            if (end_l - l != end_r - r) {
+                same = false;
+            } else {
+                while (l < end_l && s[l] == s[r]) {
+                    l++;
+                    r++;
+                }
+                if (l == n || s[l] != s[r]) {
+                    same = false;
+                }
+            }
+            if (!same) {
+                rec_upper++;
+            }
+            rec_s[lms_map[sorted_lms[i]]] = rec_upper;
+        }
+        auto rec_sa = SAIS(rec_s, rec_upper);
+        for (std::int32_t i = 0; i < m; i++) {
+            sorted_lms[i] = lms[rec_sa[i]];
+        }
+        induce(sorted_lms);
+    }
+    return sa;
+}
+
+std::vector<std::int32_t> BuildSuffixArray(std::string_view T) {
+    std::vector<std::int32_t> s (T.length());
+    for (std::size_t i = 0; i < T.length(); i++) {
+        s[i] = static_cast<unsigned char>(T[i]);
+    }
+    return SAIS(s, 255);
+}
+
+// Kasai et al. lcp[i] = LCP(suffix sa[i], suffix sa[i + 1]), for i < n - 1
+std::vector<std::int32_t> BuildLCPArray(std::string_view T, std::span<const std::int32_t> sa) {
+    const auto n = static_cast<std::int32_t>(T.length());
+    std::vector<std::int32_t> rank (n);
+    for (std::int32_t i = 0; i < n; i++) {
+        rank[sa[i]] = i;
+    }
+    std::vector<std::int32_t> lcp (std::max(n - 1, 0));
+    std::int32_t h = 0;
+    for (std::int32_t i = 0; i < n; i++) {
+        if (h) {
+            h--;
+        }
+        if (rank[i] == n - 1) {
+            h = 0;
+            continue;
+        }
+        const auto j = sa[rank[i] + 1];
+        while (i + h < n && j + h < n && T[i + h] == T[j + h]) {
+            h++;
+        }
+        lcp[rank[i]] = h;
+    }
+    return lcp;
+}
+
+// read-only mapping of a whole file
+class MappedFile {
+    void* data = nullptr;
+    std::size_t length = 0;
+
+public:
+    explicit MappedFile(const fs::path& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("cannot open " + path.string());
+        }
+        struct stat st {};
+        if (::fstat(fd, &st) < 0) {
+            ::close(fd);
+            throw std::runtime_error("cannot stat " + path.string());
+        }
+        length = static_cast<std::size_t>(st.st_size);
+        if (length) {
+            data = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("cannot map " + path.string());
+            }
+        }
+        ::close(fd);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+        if (data) {
+            ::munmap(data, length);
+        }
+    }
+
+    [[nodiscard]] const char* Data() const {
+        return static_cast<const char*>(data);
+    }
+
+    [[nodiscard]] std::size_t Length() const {
+        return length;
+    }
+};
+
+// suffix array, LCP array and text, either built in memory or mapped from a file written by Save.
+// file layout: magic, n (8 bytes each), sa (n int32), lcp (n - 1 int32, padded to n), text (n bytes).
+class SuffixArrayIndex {
+    static constexpr std::uint64_t magic = 0x3158444e49415353; // "SSAINDX1"
+
+    std::string owned_text;
+    std::vector<std::int32_t> owned_sa;
+    std::vector<std::int32_t> owned_lcp;
+    std::unique_ptr<MappedFile> file;
+
+    std::string_view text;
+    std::span<const std::int32_t> sa;
+    std::span<const std::int32_t> lcp;
+
+    SuffixArrayIndex() = default;
+
+    // views into our own storage must follow it, the text's small-string buffer included
+    void MoveFrom(SuffixArrayIndex& other) {
+        const bool owned = !other.file;
+        owned_text = std::move(other.owned_text);
+        owned_sa = std::move(other.owned_sa);
+        owned_lcp = std::move(other.owned_lcp);
+        file = std::move(other.file);
+        if (owned) {
+            text = owned_text;
+            sa = owned_sa;
+            lcp = owned_lcp;
+        } else {
+            text = other.text;
+            sa = other.sa;
+            lcp = other.lcp;
+        }
+        other.text = {};
+        other.sa = {};
+        other.lcp = {};
+    }
+
+    // first suffix rank whose prefix is not less than P, or (with upper) greater than P
+    [[nodiscard]] std::size_t Bound(std::string_view P, bool upper) const {
+        std::size_t lo = 0;
+        std::size_t hi = sa.size();
+        while (lo < hi) {
+            const std::size_t mid = lo + (hi - lo) / 2;
+            auto prefix = text.substr(sa[mid], P.length());
+            int cmp = prefix.compare(P);
+            if (cmp < 0 || (upper && cmp == 0)) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return lo;
+    }
+
+public:
+    SuffixArrayIndex(SuffixArrayIndex&& other) noexcept {
+        MoveFrom(other);
+    }
+
+    SuffixArrayIndex& operator=(SuffixArrayIndex&& other) noexcept {
+        if (this != &other) {
+            MoveFrom(other);
+        }
+        return *this;
+    }
+
+    static SuffixArrayIndex Build(std::string T) {
+        assert(T.length() < static_cast<std::size_t>(INT32_MAX));
+        SuffixArrayIndex index;
+        index.owned_text = std::move(T);
+        index.owned_sa = BuildSuffixArray(index.owned_text);
+        index.owned_lcp = BuildLCPArray(index.owned_text, index.owned_sa);
+        index.text = index.owned_text;
+        index.sa = index.owned_sa;
+        index.lcp = index.owned_lcp;
+        return index;
+    }
+
+    static SuffixArrayIndex Load(const fs::path& path) {
+        SuffixArrayIndex index;
+        index.file = std::make_unique<MappedFile>(path);
+        const char* data = index.file->Data();
+        std::uint64_t header[2] {};
+        if (index.file->Length() < sizeof(header)) {
+            throw std::runtime_error("truncated index " + path.string());
+        }
+        std::memcpy(header, data, sizeof(header));
+        const std::uint64_t n = header[1];
+        if (header[0] != magic || index.file->Length() != sizeof(header) + 2 * n * sizeof(std::int32_t) + n) {
+            throw std::runtime_error("bad index " + path.string());
+        }
+        auto ints = reinterpret_cast<const std::int32_t*>(data + sizeof(header));
+        index.sa = {ints, n};
+        index.lcp = {ints + n, n ? n - 1 : 0};
+        index.text = {data + sizeof(header) + 2 * n * sizeof(std::int32_t), n};
+        return index;
+    }
+
+    void Save(const fs::path& path) const {
+        std::ofstream out (path, std::ios::binary);
+        const std::uint64_t header[2] {magic, text.length()};
+        const std::int32_t pad = 0;
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(sa.data()), static_cast<std::streamsize>(sa.size_bytes()));
+        out.write(reinterpret_cast<const char*>(lcp.data()), static_cast<std::streamsize>(lcp.size_bytes()));
+        if (!text.empty()) {
+            out.write(reinterpret_cast<const char*>(&pad), sizeof(pad));
+        }
+        out.write(text.data(), static_cast<std::streamsize>(text.length()));
+        if (!out) {
+            throw std::runtime_error("cannot write " + path.string());
+        }
+    }
+
+    [[nodiscard]] std::string_view Text() const {
+        return text;
+    }
+
+    [[nodiscard]] std::span<const std::int32_t> SuffixArray() const {
+        return sa;
+    }
+
+    [[nodiscard]] std::span<const std::int32_t> LCPArray() const {
+        return lcp;
+    }
+
+    [[nodiscard]] std::size_t Count(std::string_view P) const {
+        return Bound(P, true) - Bound(P, false);
+    }
+
+    // shifts of all occurrences of P, in increasing order
+    [[nodiscard]] std::vector<std::size_t> Locate(std::string_view P) const {
+        std::vector<std::size_t> res;
+        for (std::size_t i = Bound(P, false), hi = Bound(P, true); i < hi; i++) {
+            res.push_back(sa[i]);
+        }
+        std::sort(res.begin(), res.end());
+        return res;
+    }
+
+    // (shift, length) of a longest substring occurring at least twice
+    [[nodiscard]] std::pair<std::size_t, std::size_t> LongestRepeatedSubstring() const {
+        if (lcp.empty()) {
+            return {0, 0};
+        }
+        auto it = std::max_element(lcp.begin(), lcp.end());
+        return {sa[it - lcp.begin()], static_cast<std::size_t>(*it)};
+    }
+
+    // each suffix contributes its length minus the prefix it shares with its predecessor
+    [[nodiscard]] std::uint64_t DistinctSubstrings() const {
+        const std::uint64_t n = text.length();
+        return n * (n + 1) / 2 - std::accumulate(lcp.begin(), lcp.end(), std::uint64_t {0});
+    }
+};
+
+int main() {
+    auto index = SuffixArrayIndex::Build("acaabcaab");
+    for (auto shift : index.Locate("aab")) {
+        std::cout << shift << ' ';
+    }
+    std::cout << '\n';
+    auto [pos, len] = index.LongestRepeatedSubstring();
+    std::cout << index.Text().substr(pos, len) << ' ' << index.DistinctSubstrings() << '\n';
+
+    // a short text lives in the string object itself, so moves must re-point the views
+    std::vector<SuffixArrayIndex> indices;
+    indices.push_back(SuffixArrayIndex::Build("acaabcaab"));
+    indices.push_back(SuffixArrayIndex::Build("ab"));
+    indices.push_back(SuffixArrayIndex::Build("abracadabra"));
+    assert((indices[0].Locate("aab") == std::vector<std::size_t> {2, 6}));
+    assert(indices[1].Count("b") == 1 && indices[2].Count("abra") == 2);
+    auto moved = std::move(indices[2]);
+    indices[1] = std::move(moved);
+    assert(indices[1].Text() == "abracadabra" && indices[1].Count("a") == 5);
+    assert(indices[2].Text().empty() && indices[2].Count("a") == 0);
+
+    std::mt19937 gen(std::random_device{}());
+    auto random_string = [&gen](std::size_t len, char hi) {
+        std::uniform_int_distribution<> dist('a', hi);
+        std::string s (len, ' ');
+        for (auto& c : s) {
+            c = static_cast<char>(dist(gen));
+        }
+        return s;
+    };
+    for (std::size_t iter = 0; iter < 300; iter++) {
+        auto T = random_string(gen() % 200, "abz"[iter % 3]);
+        auto idx = SuffixArrayIndex::Build(T);
+        std::vector<std::int32_t> expected (T.length());
+        std::iota(expected.begin(), expected.end(), 0);
+        std::string_view T_sv (T);
+        std::sort(expected.begin(), expected.end(), [&T_sv](auto a, auto b) { return T_sv.substr(a) < T_sv.substr(b); });
+        assert(std::equal(expected.begin(), expected.end(), idx.SuffixArray().begin(), idx.SuffixArray().end()));
+        std::size_t distinct = 0;
+        std::size_t longest = 0;
+        for (std::size_t i = 0; i < T.length(); i++) {
+            std::size_t l = 0;
+            if (i) {
+                auto a = T_sv.substr(expected[i - 1]);
+                auto b = T_sv.substr(expected[i]);
+                while (l < a.length() && l < b.length() && a[l] == b[l]) {
+                    l++;
+                }
+            }
+            distinct += T.length() - expected[i] - l;
+            longest = std::max(longest, l);
+        }
+        assert(idx.DistinctSubstrings() == distinct);
+        assert(idx.LongestRepeatedSubstring().second == longest);
+        auto P = random_string(1 + gen() % 3, 'b');
+        std::vector<std::size_t> occ;
+        for (auto s = T.find(P); s != std::string::npos; s = T.find(P, s + 1)) {
+            occ.push_back(s);
+        }
+        assert(idx.Locate(P) == occ && idx.Count(P) == occ.size());
+    }
+
+    auto T = random_string(std::size_t {1} << 24, 'z');
+    auto t1 = crn::steady_clock::now();
+    auto big = SuffixArrayIndex::Build(T);
+    auto t2 = crn::steady_clock::now();
+    const auto path = fs::temp_directory_path() / "suffix_array_index.bin";
+    big.Save(path);
+    auto t3 = crn::steady_clock::now();
+    auto loaded = SuffixArrayIndex::Load(path);
+    auto t4 = crn::steady_clock::now();
+    std::vector<std::string> queries (1'000'000);
+    for (auto& q : queries) {
+        auto s = gen() % (T.length() - 8);
+        q = T.substr(s, 4 + gen() % 4);
+    }
+    std::size_t total = 0;
+    auto t5 = crn::steady_clock::now();
+    for (const auto& q : queries) {
+        total += loaded.Count(q);
+    }
+    auto t6 = crn::steady_clock::now();
+    assert(loaded.Text() == T && total >= queries.size());
+    fs::remove(path);
+    std::cout << "SA-IS + Kasai over 16 MiB : " << crn::duration_cast<crn::milliseconds>(t2 - t1).count() << "ms\n";
+    std::cout << "Save : " << crn::duration_cast<crn::milliseconds>(t3 - t2).count() << "ms, "
+              << "Load : " << crn::duration_cast<crn::microseconds>(t4 - t3).count() << "us\n";
+    std::cout << "1M count queries : " << crn::duration_cast<crn::milliseconds>(t6 - t5).count() << "ms\n";
+}
@@ -0,0 +1,350 @@
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace crn = std::chrono;
+
+using u64 = std::uint64_t;
+
+bool GapMatching(const std::string& T, const std::string& P,
+                 const char delimeter = ' ', std::size_t t = 0, std::size_t p = 0) {
+    if (p == P.length()) {
+        return t <= T.length();
+    }
+    if (t == T.length()) {
+        return false;
+    }
+    if (T[t] == P[p]) {
+        if (p + 1 < P.length() && P[p + 1] == delimeter) {
+            return GapMatching(T, P, delimeter, t + 1, p + 2);
+        } else {
+            return GapMatching(T, P, delimeter, t + 1, p + 1);
+        }
+    } else {
+        return GapMatching(T, P, delimeter, t + 1, p);
+    }
+}
+
+using CharClass = std::bitset<256>;
+
+// '.' matches any byte, "[a-z0-9_]" a class ("[^...]" its complement), '\' escapes the next byte
+std::vector<CharClass> ParseCharClasses(std::string_view P) {
+    std::vector<CharClass> res;
+    for (std::size_t i = 0; i < P.length(); i++) {
+        CharClass cls;
+        if (P[i] == '.') {
+            cls.set();
+        } else if (P[i] == '[') {
+            std::size_t j = i + 1;
+            const bool negate = j < P.length() && P[j] == '^';
+            if (negate) {
+                j++;
+            }
+            for (; j < P.length() && P[j] != ']'; j++) {
+                if (P[j] == '\\' && j + 1 < P.length()) {
+                    j++;
+                }
+                auto lo = static_cast<unsigned char>(P[j]);
+                auto hi = lo;
+                if (j + 2 < P.length() && P[j + 1] == '-' && P[j + 2] != ']') {
+                    hi = static_cast<unsigned char>(P[j + 2]);
+                    j += 2;
+                }
+                for (std::size_t c = lo; c <= hi; c++) {
+                    cls.set(c);
+                }
+            }
+            assert(j < P.length());
+            if (negate) {
+                cls.flip();
+            }
+            i = j;
+        } else {
+            if (P[i] == '\\' && i + 1 < P.length()) {
+                i++;
+            }
+            cls.set(static_cast<unsigned char>(P[i]));
+        }
+        res.push_back(cls);
+    }
+    return res;
+}
+
+// B[c * nw + w]: word w of the set of pattern positions whose class contains c
+std::vector<u64> BuildMasks(const std::vector<CharClass>& P, std::size_t nw) {
+    std::vector<u64> B (256 * nw);
+    for (std::size_t i = 0; i < P.size(); i++) {
+        for (std::size_t c = 0; c < 256; c++) {
+            if (P[i][c]) {
+                B[c * nw + i / 64] |= u64 {1} << (i % 64);
+            }
+        }
+    }
+    return B;
+}
+
+// dst = (src << 1) | 1 over nw words
+template <std::size_t FixedWords>
+void ShiftInOne(const u64* src, u64* dst, std::size_t nw) {
+    if constexpr (FixedWords) {
+        nw = FixedWords;
+    }
+    u64 carry = 1;
+    for (std::size_t w = 0; w < nw; w++) {
+        const u64 next = src[w] >> 63;
+        dst[w] = (src[w] << 1) | carry;
+        carry = next;
+    }
+}
+
+// Shift-Or (Baeza-Yates and Gonnet) for a literal pattern of at most 64 bytes:
+// bit i of D is 0 iff P[0..i] matches the text ending here.
+std::vector<std::size_t> ShiftOrMatcher(std::string_view T, std::string_view P) {
+    assert(!P.empty() && P.length() <= 64);
+    const std::size_t m = P.length();
+    std::vector<std::size_t> res;
+    std::array<u64, 256> B;
+    B.fill(~u64 {0});
+    for (std::size_t i = 0; i < m; i++) {
+        B[static_cast<unsigned char>(P[i])] &= ~(u64 {1} << i);
+    }
+    const u64 hit = u64 {1} << (m - 1);
+    u64 D = ~u64 {0};
+    for (std::size_t j = 0; j < T.length(); j++) {
+        D = (D << 1) | B[static_cast<unsigned char>(T[j])];
+        if (!(D & hit)) {
+            res.push_back(j + 1 - m);
+        }
+    }
+    return res;
+}
+
+template <std::size_t FixedWords>
+std::vector<std::size_t> ShiftAndKernel(std::string_view T, const std::vector<CharClass>& P, std::size_t first_only) {
+    const std::size_t m = P.size();
+    const std::size_t nw = FixedWords ? FixedWords : (m + 63) / 64;
+    const auto B = BuildMasks(P, nw);
+    const std::size_t hit_word = (m - 1) / 64;
+    const u64 hit = u64 {1} << ((m - 1) % 64);
+    std::vector<u64> D (nw);
+    std::vector<std::size_t> res;
+    for (std::size_t j = 0; j < T.length(); j++) {
+        const u64* b = B.data() + static_cast<unsigned char>(T[j]) * nw;
+        ShiftInOne<FixedWords>(D.data(), D.data(), nw);
+        for (std::size_t w = 0; w < nw; w++) {
+            D[w] &= b[w];
+        }
+        if (D[hit_word] & hit) {
+            res.push_back(j + 1 - m);
+            if (res.size() == first_only) {
+                break;
+            }
+        }
+    }
+    return res;
+}
+
+// Shift-And over character classes; one word for m <= 64, multiple words beyond.
+// stops after first_only matches if it is nonzero.
+std::vector<std::size_t> ShiftAndMatcher(std::string_view T, const std::vector<CharClass>& P, std::size_t first_only = 0) {
+    assert(!P.empty());
+    if (P.size() <= 64) {
+        return ShiftAndKernel<1>(T, P, first_only);
+    }
+    return ShiftAndKernel<0>(T, P, first_only);
+}
+
+std::vector<std::size_t> ShiftAndMatcher(std::string_view T, std::string_view P) {
+    return ShiftAndMatcher(T, ParseCharClasses(P));
+}
+
+enum class ErrorModel {
+    Mismatches, // substitutions only (Hamming distance)
+    Differences, // insertions, deletions and substitutions (edit distance)
+};
+
+// Wu and Manber. R_d holds the pattern prefixes that match a suffix of the text read so far
+// with at most d errors; for differences
+//   R'_d = ((R_d << 1 | 1) & B[c]) | R_{d-1} | (R_{d-1} << 1 | 1) | (R'_{d-1} << 1 | 1)
+// (match, insertion, substitution, deletion). with mismatches only the substitution term remains.
+template <std::size_t FixedWords>
+std::vector<std::size_t> ApproximateKernel(std::string_view T, const std::vector<CharClass>& P, std::size_t k, ErrorModel model) {
+    const std::size_t m = P.size();
+    const std::size_t nw = FixedWords ? FixedWords : (m + 63) / 64;
+    const auto B = BuildMasks(P, nw);
+    const std::size_t hit_word = (m - 1) / 64;
+    const u64 hit = u64 {1} << ((m - 1) % 64);
+
+    std::vector<u64> R ((k + 1) * nw);
+    if (model == ErrorModel::Differences) {
+        // the first d pattern characters can be deleted
+        for (std::size_t d = 1; d <= k; d++) {
+            for (std::size_t i = 0; i < std::min(d, m); i++) {
+                R[d * nw + i / 64] |= u64 {1} << (i % 64);
+            }
+        }
+    }
+    std::vector<u64> old_prev (nw);
+    std::vector<u64> old_cur (nw);
+    std::vector<u64> tmp (nw);
+    std::vector<std::size_t> res;
+    for (std::size_t j = 0; j < T.length(); j++) {
+        const u64* b = B.data() + static_cast<unsigned char>(T[j]) * nw;
+        for (std::size_t d = 0; d <= k; d++) {
+            u64* cur = R.data() + d * nw;
+            std::copy_n(cur, nw, old_cur.data());
+            ShiftInOne<FixedWords>(cur, cur, nw);
+            for (std::size_t w = 0; w < nw; w++) {
+                cur[w] &= b[w];
+            }
+            if (d) {
+                const u64* new_prev = cur - nw;
+                ShiftInOne<FixedWords>(old_prev.data(), tmp.data(), nw);
+                for (std::size_t w = 0; w < nw; w++) {
+                    cur[w] |= tmp[w];
+                }
+                if (model == ErrorModel::Differences) {
+                    for (std::size_t w = 0; w < nw; w++) {
+                        cur[w] |= old_prev[w];
+                    }
+                    ShiftInOne<FixedWords>(new_prev, tmp.data(), nw);
+                    for (std::size_t w = 0; w < nw; w++) {
+                        cur[w] |= tmp[w];
+                    }
+                }
+            }
+            std::swap(old_prev, old_cur);
+        }
+        if (R[k * nw + hit_word] & hit) {
+            res.push_back(j + 1);
+        }
+    }
+    return res;
+}
+
+// end positions e (exclusive) such that some substring T[s..e) is within k errors of P.
+// for ErrorModel::Mismatches the occurrence is T[e - m..e).
+std::vector<std::size_t> ApproximateMatcher(std::string_view T, const std::vector<CharClass>& P, std::size_t k,
+                                            ErrorModel model = ErrorModel::Differences) {
+    assert(!P.empty() && k < P.size());
+    if (P.size() <= 64) {
+        return ApproximateKernel<1>(T, P, k, model);
+    }
+    return ApproximateKernel<0>(T, P, k, model);
+}
+
+std::vector<std::size_t> ApproximateMatcher(std::string_view T, std::string_view P, std::size_t k,
+                                            ErrorModel model = ErrorModel::Differences) {
+    return ApproximateMatcher(T, ParseCharClasses(P), k, model);
+}
+
+// pieces of P separated by the gap character must occur in order, without overlapping,
+// each piece as a contiguous substring; every piece is searched with Shift-And.
+bool BitParallelGapMatching(std::string_view T, std::string_view P, const char delimeter = ' ') {
+    std::size_t t = 0;
+    std::size_t start = 0;
+    while (start <= P.length()) {
+        auto end = std::min(P.find(delimeter, start), P.length());
+        auto piece = P.substr(start, end - start);
+        start = end + 1;
+        if (piece.empty()) {
+            continue;
+        }
+        auto classes = ParseCharClasses(piece);
+        auto found = ShiftAndMatcher(T.substr(t), classes, 1);
+        if (found.empty()) {
+            return false;
+        }
+        t += found[0] + classes.size();
+    }
+    return true;
+}
+
+// Sellers' dynamic program, for checking
+std::vector<std::size_t> SellersMatcher(std::string_view T, std::string_view P, std::size_t k) {
+    const std::size_t m = P.length();
+    std::vector<std::size_t> C (m + 1);
+    for (std::size_t i = 0; i <= m; i++) {
+        C[i] = i;
+    }
+    std::vector<std::size_t> res;
+    for (std::size_t j = 0; j < T.length(); j++) {
+        std::size_t diag = 0;
+        for (std::size_t i = 1; i <= m; i++) {
+            std::size_t up = C[i];
+            C[i] = std::min({C[i] + 1, C[i - 1] + 1, diag + (P[i - 1] != T[j])});
+            diag = up;
+        }
+        if (C[m] <= k) {
+            res.push_back(j + 1);
+        }
+    }
+    return res;
+}
+
+int main() {
+    assert(GapMatching("cabccbacbacab", "ab ba c"));
+    assert(BitParallelGapMatching("cabccbacbacab", "ab ba c"));
+    assert(!BitParallelGapMatching("cabccbacbacab", "cab cab ba"));
+    for (auto shift : ShiftAndMatcher("acaabc", "a[ab]b")) {
+        std::cout << shift << ' ';
+    }
+    std::cout << '\n';
+
+    std::mt19937 gen(std::random_device{}());
+    auto random_string = [&gen](std::size_t len, char hi) {
+        std::uniform_int_distribution<> dist('a', hi);
+        std::string s (len, ' ');
+        for (auto& c : s) {
+            c = static_cast<char>(dist(gen));
+        }
+        return s;
+    };
+    for (std::size_t iter = 0; iter < 300; iter++) {
+        auto T = random_string(gen() % 400, 'c');
+        auto P = random_string(1 + gen() % (iter % 2 ? 150 : 8), 'c');
+        std::vector<std::size_t> exact;
+        for (auto s = T.find(P); s != std::string::npos; s = T.find(P, s + 1)) {
+            exact.push_back(s);
+        }
+        if (P.length() <= 64) {
+            assert(ShiftOrMatcher(T, P) == exact);
+        }
+        assert(ShiftAndMatcher(T, P) == exact);
+        const std::size_t k = gen() % std::min<std::size_t>(P.length(), 4);
+        assert(ApproximateMatcher(T, P, k) == SellersMatcher(T, P, k));
+        std::vector<std::size_t> hamming;
+        for (std::size_t s = 0; s + P.length() <= T.length(); s++) {
+            std::size_t diff = 0;
+            for (std::size_t i = 0; i < P.length(); i++) {
+                diff += T[s + i] != P[i];
+            }
+            if (diff <= k) {
+                hamming.push_back(s + P.length());
+            }
+        }
+        assert(ApproximateMatcher(T, P, k, ErrorModel::Mismatches) == hamming);
+    }
+
+    auto T = random_string(std::size_t {1} << 24, 'z');
+    const std::string P = "connectionreset";
+    auto t1 = crn::steady_clock::now();
+    auto r1 = ShiftOrMatcher(T, P);
+    auto t2 = crn::steady_clock::now();
+    auto r2 = ApproximateMatcher(T, "conn[a-z]ction.reset", 2);
+    auto t3 = crn::steady_clock::now();
+    auto r3 = ApproximateMatcher(T, std::string(100, 'q'), 3);
+    auto t4 = crn::steady_clock::now();
+    std::cout << "Shift-Or, exact : " << crn::duration_cast<crn::milliseconds>(t2 - t1).count() << "ms\n";
+    std::cout << "Wu-Manber, classes, k = 2 : " << crn::duration_cast<crn::milliseconds>(t3 - t2).count() << "ms\n";
+    std::cout << "Wu-Manber, m = 100 (2 words), k = 3 : " << crn::duration_cast<crn::milliseconds>(t4 - t3).count() << "ms\n";
+}
@@ -0,0 +1,152 @@
+#include <bit>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__SSE2__) || defined(__AVX2__) || defined(__AVX512BW__)
+#include <immintrin.h>
+#endif
+
+namespace crn = std::chrono;
+
+std::vector<std::size_t> NaiveStringMatcher(const std::string& T, const std::string& P) {
+    assert(!T.empty() && !P.empty());
+    const std::size_t n = T.length();
+    const std::size_t m = P.length();
+    std::vector<std::size_t> res;
+    if (n < m) {
+        return res;
+    }
+    std::string_view T_sv (T);
+    std::string_view P_sv (P);
+    for (std::size_t s = 0; s <= n - m; s++) {
+        if (P_sv.substr(0, m) == T_sv.substr(s, m)) {
+            res.push_back(s);
+        }
+    }
+    return res;
+}
+
+// bit j is set iff T[s + j] == P[0] and T[s + j + m - 1] == P[m - 1], for the
+// simd_width shifts starting at s. requires s + m - 1 + simd_width <= n.
+#if defined(__AVX512BW__)
+constexpr std::size_t simd_width = 64;
+
+std::uint64_t CandidateMask(const char* first, const char* last, char p0, char p1) {
+    const __m512i f = _mm512_loadu_si512(first);
+    const __m512i l = _mm512_loadu_si512(last);
+    return _mm512_cmpeq_epi8_mask(f, _mm512_set1_epi8(p0)) & _mm512_cmpeq_epi8_mask(l, _mm512_set1_epi8(p1));
+}
+#elif defined(__AVX2__)
+constexpr std::size_t simd_width = 32;
+
+std::uint64_t CandidateMask(const char* first, const char* last, char p0, char p1) {
+    const __m256i f = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+    const __m256i l = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(last));
+    const __m256i eq = _mm256_and_si256(_mm256_cmpeq_epi8(f, _mm256_set1_epi8(p0)),
+                                        _mm256_cmpeq_epi8(l, _mm256_set1_epi8(p1)));
+    return static_cast<std::uint32_t>(_mm256_movemask_epi8(eq));
+}
+#elif defined(__SSE2__)
+constexpr std::size_t simd_width = 16;
+
+std::uint64_t CandidateMask(const char* first, const char* last, char p0, char p1) {
+    const __m128i f = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+    const __m128i l = _mm_loadu_si128(reinterpret_cast<const __m128i*>(last));
+    const __m128i eq = _mm_and_si128(_mm_cmpeq_epi8(f, _mm_set1_epi8(p0)),
+                                     _mm_cmpeq_epi8(l, _mm_set1_epi8(p1)));
+    return static_cast<std::uint32_t>(_mm_movemask_epi8(eq));
+}
+#else
+constexpr std::size_t simd_width = 8;
+
+// portable fallback for targets without SSE2
+std::uint64_t CandidateMask(const char* first, const char* last, char p0, char p1) {
+    std::uint64_t mask = 0;
+    for (std::size_t j = 0; j < simd_width; j++) {
+        mask |= static_cast<std::uint64_t>(first[j] == p0 && last[j] == p1) << j;
+    }
+    return mask;
+}
+#endif
+
+// the pattern's first and last bytes are compared at simd_width shifts per step,
+// and only shifts passing both are verified with memcmp.
+std::vector<std::size_t> SimdStringMatcher(std::string_view T, std::string_view P) {
+    assert(!T.empty() && !P.empty());
+    const std::size_t n = T.length();
+    const std::size_t m = P.length();
+    std::vector<std::size_t> res;
+    if (n < m) {
+        return res;
+    }
+    const char* t = T.data();
+    const char* p = P.data();
+    const char p0 = P[0];
+    const char p1 = P[m - 1];
+    std::size_t s = 0;
+    for (; s + m - 1 + simd_width <= n; s += simd_width) {
+        std::uint64_t mask = CandidateMask(t + s, t + s + m - 1, p0, p1);
+        while (mask) {
+            const std::size_t j = s + std::countr_zero(mask);
+            if (m <= 2 || !std::memcmp(t + j + 1, p + 1, m - 2)) {
+                res.push_back(j);
+            }
+            mask &= mask - 1;
+        }
+    }
+    for (; s <= n - m; s++) {
+        if (t[s] == p0 && t[s + m - 1] == p1 && !std::memcmp(t + s, p, m)) {
+            res.push_back(s);
+        }
+    }
+    return res;
+}
+
+int main() {
+    auto res = SimdStringMatcher("acaabc", "aab");
+    for (auto shift : res) {
+        std::cout << shift << ' ';
+    }
+    std::cout << '\n';
+
+    std::mt19937 gen(std::random_device{}());
+    std::uniform_int_distribution<> dist('a', 'c');
+    for (std::size_t iter = 0; iter < 1'000; iter++) {
+        std::string T (1 + gen() % 300, ' ');
+        std::string P (1 + gen() % 6, ' ');
+        for (auto& c : T) {
+            c = static_cast<char>(dist(gen));
+        }
+        for (auto& c : P) {
+            c = static_cast<char>(dist(gen));
+        }
+        assert(SimdStringMatcher(T, P) == NaiveStringMatcher(T, P));
+    }
+
+    // log-like text over a larger alphabet
+    constexpr std::size_t N = 1u << 26;
+    std::uniform_int_distribution<> log_dist(' ', '~');
+    std::string T (N, ' ');
+    for (auto& c : T) {
+        c = static_cast<char>(log_dist(gen));
+    }
+    const std::string P = "connection reset";
+    T.replace(N / 2, P.length(), P);
+    auto t1 = crn::steady_clock::now();
+    auto r1 = NaiveStringMatcher(T, P);
+    auto t2 = crn::steady_clock::now();
+    auto r2 = SimdStringMatcher(T, P);
+    auto t3 = crn::steady_clock::now();
+    assert(r1 == r2);
+    std::cout << "Naive : " << crn::duration_cast<crn::milliseconds>(t2 - t1).count() << "ms\n";
+    std::cout << "SIMD (" << simd_width << " shifts per step) : "
+              << crn::duration_cast<crn::milliseconds>(t3 - t2).count() << "ms\n";
+}
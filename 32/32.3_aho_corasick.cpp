@@ -0,0 +1,239 @@
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace crn = std::chrono;
+namespace sr = std::ranges;
+
+// multiple pattern matcher. the trie's failure links are either compiled into a dense
+// transition table over byte equivalence classes, or kept as failure links over sparse rows
+// when the dense table would exceed dense_limit bytes.
+class AhoCorasick {
+    static constexpr std::uint32_t none = UINT32_MAX;
+
+    std::array<std::uint16_t, 256> byte_class {}; // bytes that occur in no pattern share class 0
+    std::size_t num_classes = 1;
+    std::size_t num_states = 1;
+    bool dense = false;
+
+    std::vector<std::uint32_t> delta; // dense: delta[q * num_classes + c]
+
+    // sparse rows: children of q are row_class/row_next[row_begin[q] .. row_begin[q + 1]), sorted by class
+    std::vector<std::uint32_t> row_begin;
+    std::vector<std::uint16_t> row_class;
+    std::vector<std::uint32_t> row_next;
+    std::vector<std::uint32_t> fail;
+
+    // patterns ending at q are out_ids[out_begin[q] .. out_begin[q + 1]), then those of dict_link[q]
+    std::vector<std::uint32_t> out_begin;
+    std::vector<std::uint32_t> out_ids;
+    std::vector<std::uint32_t> dict_link;
+    std::vector<std::size_t> lengths;
+
+    [[nodiscard]] std::uint32_t SparseGoto(std::uint32_t q, std::uint16_t c) const {
+        auto first = row_class.begin() + row_begin[q];
+        auto last = row_class.begin() + row_begin[q + 1];
+        auto it = std::lower_bound(first, last, c);
+        return (it != last && *it == c) ? row_next[it - row_class.begin()] : none;
+    }
+
+    [[nodiscard]] std::uint32_t Next(std::uint32_t q, std::uint16_t c) const {
+        if (dense) {
+            return delta[q * num_classes + c];
+        }
+        while (true) {
+            auto next = SparseGoto(q, c);
+            if (next != none) {
+                return next;
+            }
+            if (!q) {
+                return 0;
+            }
+            q = fail[q];
+        }
+    }
+
+public:
+    explicit AhoCorasick(const std::vector<std::string>& patterns, std::size_t dense_limit = std::size_t {1} << 26) {
+        assert(!patterns.empty());
+        std::array<bool, 256> used {};
+        for (const auto& pattern : patterns) {
+            assert(!pattern.empty());
+            for (unsigned char ch : pattern) {
+                used[ch] = true;
+            }
+        }
+        for (std::size_t b = 0; b < 256; b++) {
+            if (used[b]) {
+                byte_class[b] = static_cast<std::uint16_t>(num_classes++);
+            }
+        }
+
+        // trie
+        std::vector<std::vector<std::pair<std::uint16_t, std::uint32_t>>> children (1);
+        std::vector<std::vector<std::uint32_t>> ids (1);
+        for (std::size_t j = 0; j < patterns.size(); j++) {
+            std::uint32_t q = 0;
+            for (unsigned char ch : patterns[j]) {
+                const auto c = byte_class[ch];
+                auto it = sr::find(children[q], c, &std::pair<std::uint16_t, std::uint32_t>::first);
+                if (it != children[q].end()) {
+                    q = it->second;
+                } else {
+                    const auto next = static_cast<std::uint32_t>(children.size());
+                    children[q].emplace_back(c, next);
+                    children.emplace_back();
+                    ids.emplace_back();
+                    q = next;
+                }
+            }
+            ids[q].push_back(static_cast<std::uint32_t>(j));
+            lengths.push_back(patterns[j].length());
+        }
+        num_states = children.size();
+        dense = num_states * num_classes * sizeof(std::uint32_t) <= dense_limit;
+
+        row_begin.resize(num_states + 1);
+        for (std::size_t q = 0; q < num_states; q++) {
+            sr::sort(children[q]);
+            row_begin[q + 1] = row_begin[q] + static_cast<std::uint32_t>(children[q].size());
+        }
+        row_class.reserve(row_begin[num_states]);
+        row_next.reserve(row_begin[num_states]);
+        for (const auto& row : children) {
+            for (auto [c, next] : row) {
+                row_class.push_back(c);
+                row_next.push_back(next);
+            }
+        }
+        out_begin.resize(num_states + 1);
+        for (std::size_t q = 0; q < num_states; q++) {
+            out_begin[q + 1] = out_begin[q] + static_cast<std::uint32_t>(ids[q].size());
+            out_ids.insert(out_ids.end(), ids[q].begin(), ids[q].end());
+        }
+
+        // failure links in breadth-first order, so fail[q] is final before q's children
+        fail.assign(num_states, 0);
+        dict_link.assign(num_states, none);
+        if (dense) {
+            delta.assign(num_states * num_classes, 0);
+        }
+        std::queue<std::uint32_t> Q;
+        Q.push(0);
+        while (!Q.empty()) {
+            auto q = Q.front();
+            Q.pop();
+            if (dense) {
+                // inherit the failure state's row, then overwrite with q's own children
+                if (q) {
+                    std::copy_n(delta.begin() + fail[q] * num_classes, num_classes, delta.begin() + q * num_classes);
+                }
+            }
+            for (auto [c, next] : children[q]) {
+                if (q) {
+                    fail[next] = dense ? delta[fail[q] * num_classes + c] : Next(fail[q], c);
+                }
+                const auto f = fail[next];
+                dict_link[next] = (out_begin[f] != out_begin[f + 1]) ? f : dict_link[f];
+                if (dense) {
+                    delta[q * num_classes + c] = next;
+                }
+                Q.push(next);
+            }
+        }
+    }
+
+    [[nodiscard]] bool IsDense() const {
+        return dense;
+    }
+
+    [[nodiscard]] std::size_t NumStates() const {
+        return num_states;
+    }
+
+    // (pattern id, shift) for every occurrence, ordered by end position
+    [[nodiscard]] std::vector<std::pair<std::size_t, std::size_t>> Match(std::string_view T) const {
+        std::vector<std::pair<std::size_t, std::size_t>> res;
+        std::uint32_t q = 0;
+        for (std::size_t i = 0; i < T.length(); i++) {
+            q = Next(q, byte_class[static_cast<unsigned char>(T[i])]);
+            for (auto r = q; r != none; r = dict_link[r]) {
+                for (auto k = out_begin[r]; k < out_begin[r + 1]; k++) {
+                    res.emplace_back(out_ids[k], i + 1 - lengths[out_ids[k]]);
+                }
+            }
+        }
+        return res;
+    }
+};
+
+std::vector<std::pair<std::size_t, std::size_t>> NaiveMultipleMatcher(const std::string& T, const std::vector<std::string>& patterns) {
+    std::vector<std::pair<std::size_t, std::size_t>> res;
+    for (std::size_t j = 0; j < patterns.size(); j++) {
+        for (auto s = T.find(patterns[j]); s != std::string::npos; s = T.find(patterns[j], s + 1)) {
+            res.emplace_back(j, s);
+        }
+    }
+    return res;
+}
+
+int main() {
+    std::vector<std::string> patterns {"bac", "cbacd", "dacb", "bb"};
+    AhoCorasick ac (patterns);
+    for (const auto& [index, shift] : ac.Match("ababacbacdacbdbbcd")) {
+        std::cout << index << ' ' << shift << '\n';
+    }
+
+    std::mt19937 gen(std::random_device{}());
+    auto random_string = [&gen](std::size_t len, char lo, char hi) {
+        std::uniform_int_distribution<> dist(lo, hi);
+        std::string s (len, ' ');
+        for (auto& c : s) {
+            c = static_cast<char>(dist(gen));
+        }
+        return s;
+    };
+    for (std::size_t iter = 0; iter < 200; iter++) {
+        std::vector<std::string> P (1 + gen() % 20);
+        for (auto& p : P) {
+            p = random_string(1 + gen() % 5, 'a', 'c');
+        }
+        auto T = random_string(gen() % 500, 'a', 'd');
+        auto expected = NaiveMultipleMatcher(T, P);
+        sr::sort(expected);
+        for (std::size_t limit : {std::size_t {0}, std::size_t {1} << 26}) {
+            auto res = AhoCorasick(P, limit).Match(T);
+            sr::sort(res);
+            assert(res == expected);
+        }
+    }
+
+    // blocklist of 50k patterns against 16 MiB of text
+    std::vector<std::string> blocklist (50'000);
+    for (auto& p : blocklist) {
+        p = random_string(6 + gen() % 10, 'a', 'z');
+    }
+    auto T = random_string(std::size_t {1} << 24, 'a', 'z');
+    for (std::size_t limit : {std::size_t {1} << 28, std::size_t {0}}) {
+        auto t1 = crn::steady_clock::now();
+        AhoCorasick automaton (blocklist, limit);
+        auto t2 = crn::steady_clock::now();
+        auto res = automaton.Match(T);
+        auto t3 = crn::steady_clock::now();
+        std::cout << (automaton.IsDense() ? "Dense" : "Sparse") << " automaton with " << automaton.NumStates()
+                  << " states, build : " << crn::duration_cast<crn::milliseconds>(t2 - t1).count()
+                  << "ms, match : " << crn::duration_cast<crn::milliseconds>(t3 - t2).count() << "ms, "
+                  << res.size() << " matches\n";
+    }
+}
@@ -0,0 +1,198 @@
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace crn = std::chrono;
+
+constexpr std::size_t num_chars = 26;
+constexpr char start_char = 'a';
+
+bool SuffixCheck(std::string_view P_sv, std::size_t k, std::size_t q, char c) {
+    return (k == 0) || (P_sv.substr(0, k - 1) == P_sv.substr(q - (k - 1), k - 1) && P_sv[k - 1] == c);
+}
+
+std::vector<std::size_t> ComputeTransitionFunction(const std::string& P) {
+    assert(!P.empty());
+    const std::size_t m = P.length();
+    std::string_view P_sv (P);
+    std::vector<std::size_t> delta (num_chars * (m + 1));
+    for (std::size_t q = 0; q <= m; q++) {
+        for (char c = start_char; c < start_char + static_cast<char>(num_chars); c++) {
+            std::size_t k = std::min(m + 1, q + 2);
+            do {
+                k--;
+            } while (!SuffixCheck(P_sv, k, q, c));
+            delta[q * num_chars + c - start_char] = k;
+        }
+    }
+    return delta;
+}
+
+std::vector<std::size_t> ComputePrefixFunction(std::string_view P) {
+    assert(!P.empty());
+    const std::size_t m = P.length();
+    std::vector<std::size_t> pi(m + 1);
+    std::size_t k = 0;
+    for (std::size_t q = 2; q <= m; q++) {
+        while (k && P[k] != P[q - 1]) {
+            k = pi[k];
+        }
+        if (P[k] == P[q - 1]) {
+            k++;
+        }
+        pi[q] = k;
+    }
+    return pi;
+}
+
+// transition function over bytes in O(m |classes|): row q is row pi[q] with the single
+// transition on P[q] replaced. states are stored as State (uint16_t or uint32_t), one
+// contiguous row per state. with compress_alphabet, bytes that do not occur in P share
+// class 0, so a row holds (distinct bytes of P) + 1 entries instead of 256.
+template <std::unsigned_integral State>
+class TransitionTable {
+    std::array<std::uint8_t, 256> byte_class {};
+    std::size_t num_classes = 0;
+    std::size_t m = 0;
+    std::vector<State> delta;
+
+public:
+    explicit TransitionTable(std::string_view P, bool compress_alphabet = true) : m {P.length()} {
+        assert(!P.empty() && m < std::numeric_limits<State>::max());
+        if (compress_alphabet) {
+            std::array<bool, 256> used {};
+            for (unsigned char c : P) {
+                used[c] = true;
+            }
+            num_classes = 1;
+            for (std::size_t b = 0; b < 256; b++) {
+                byte_class[b] = used[b] ? static_cast<std::uint8_t>(num_classes++) : 0;
+            }
+        } else {
+            num_classes = 256;
+            for (std::size_t b = 0; b < 256; b++) {
+                byte_class[b] = static_cast<std::uint8_t>(b);
+            }
+        }
+        auto pi = ComputePrefixFunction(P);
+        delta.assign((m + 1) * num_classes, 0);
+        delta[byte_class[static_cast<unsigned char>(P[0])]] = 1;
+        for (std::size_t q = 1; q <= m; q++) {
+            std::copy_n(delta.begin() + pi[q] * num_classes, num_classes, delta.begin() + q * num_classes);
+            if (q < m) {
+                delta[q * num_classes + byte_class[static_cast<unsigned char>(P[q])]] = static_cast<State>(q + 1);
+            }
+        }
+    }
+
+    [[nodiscard]] State Next(State q, char c) const {
+        return delta[q * num_classes + byte_class[static_cast<unsigned char>(c)]];
+    }
+
+    [[nodiscard]] std::size_t PatternLength() const {
+        return m;
+    }
+
+    [[nodiscard]] std::size_t NumClasses() const {
+        return num_classes;
+    }
+
+    [[nodiscard]] std::size_t Bytes() const {
+        return delta.size() * sizeof(State);
+    }
+};
+
+template <std::unsigned_integral State>
+std::vector<std::size_t> FiniteAutomatonMatcher(std::string_view T, const TransitionTable<State>& delta) {
+    const std::size_t n = T.length();
+    const std::size_t m = delta.PatternLength();
+    std::vector<std::size_t> res;
+    if (n < m) {
+        return res;
+    }
+    State q = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        q = delta.Next(q, T[i]);
+        if (q == m) {
+            res.push_back((i + 1) - m);
+        }
+    }
+    return res;
+}
+
+// 16-bit states while the pattern allows it
+std::vector<std::size_t> FiniteAutomatonMatcher(std::string_view T, std::string_view P) {
+    if (P.length() < std::numeric_limits<std::uint16_t>::max()) {
+        return FiniteAutomatonMatcher(T, TransitionTable<std::uint16_t>(P));
+    }
+    return FiniteAutomatonMatcher(T, TransitionTable<std::uint32_t>(P));
+}
+
+int main() {
+    auto res = FiniteAutomatonMatcher("acaabc", "aab");
+    for (auto shift : res) {
+        std::cout << shift << ' ';
+    }
+    std::cout << '\n';
+
+    std::mt19937 gen(std::random_device{}());
+    auto random_string = [&gen](std::size_t len, char hi) {
+        std::uniform_int_distribution<> dist(start_char, hi);
+        std::string s (len, ' ');
+        for (auto& c : s) {
+            c = static_cast<char>(dist(gen));
+        }
+        return s;
+    };
+    for (std::size_t iter = 0; iter < 200; iter++) {
+        auto P = random_string(1 + gen() % 12, 'c');
+        auto expected = ComputeTransitionFunction(P);
+        TransitionTable<std::uint16_t> compressed (P);
+        TransitionTable<std::uint32_t> full (P, false);
+        for (std::size_t q = 0; q <= P.length(); q++) {
+            for (char c = start_char; c < start_char + static_cast<char>(num_chars); c++) {
+                auto e = expected[q * num_chars + c - start_char];
+                assert(compressed.Next(static_cast<std::uint16_t>(q), c) == e);
+                assert(full.Next(static_cast<std::uint32_t>(q), c) == e);
+            }
+        }
+    }
+
+    auto P = random_string(200, 'b');
+    auto t1 = crn::steady_clock::now();
+    auto slow = ComputeTransitionFunction(P);
+    auto t2 = crn::steady_clock::now();
+    TransitionTable<std::uint16_t> fast (P);
+    auto t3 = crn::steady_clock::now();
+    std::cout << "m = 200, SuffixCheck : " << crn::duration_cast<crn::microseconds>(t2 - t1).count() << "us, "
+              << "prefix function : " << crn::duration_cast<crn::microseconds>(t3 - t2).count() << "us\n";
+
+    auto long_P = random_string(10'000, 'z');
+    auto t4 = crn::steady_clock::now();
+    TransitionTable<std::uint16_t> compressed (long_P);
+    auto t5 = crn::steady_clock::now();
+    TransitionTable<std::uint32_t> full (long_P, false);
+    auto t6 = crn::steady_clock::now();
+    std::cout << "m = 10000, " << compressed.NumClasses() << " classes : "
+              << crn::duration_cast<crn::microseconds>(t5 - t4).count() << "us, " << compressed.Bytes() << " bytes\n";
+    std::cout << "m = 10000, 256 classes : "
+              << crn::duration_cast<crn::microseconds>(t6 - t5).count() << "us, " << full.Bytes() << " bytes\n";
+
+    auto T = random_string(std::size_t {1} << 24, 'z');
+    T.replace(T.length() / 2, long_P.length(), long_P);
+    auto t7 = crn::steady_clock::now();
+    auto r = FiniteAutomatonMatcher(T, compressed);
+    auto t8 = crn::steady_clock::now();
+    assert(r.size() == 1 && r[0] == T.length() / 2);
+    std::cout << "Matching 16 MiB : " << crn::duration_cast<crn::milliseconds>(t8 - t7).count() << "ms\n";
+}
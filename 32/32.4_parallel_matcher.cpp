@@ -0,0 +1,370 @@
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__SSE2__) || defined(__AVX2__) || defined(__AVX512BW__)
+#include <immintrin.h>
+#endif
+
+namespace crn = std::chrono;
+namespace fs = std::filesystem;
+
+std::vector<std::size_t> ComputePrefixFunction(std::string_view P) {
+    assert(!P.empty());
+    const std::size_t m = P.length();
+    std::vector<std::size_t> pi(m + 1);
+    std::size_t k = 0;
+    for (std::size_t q = 2; q <= m; q++) {
+        while (k && P[k] != P[q - 1]) {
+            k = pi[k];
+        }
+        if (P[k] == P[q - 1]) {
+            k++;
+        }
+        pi[q] = k;
+    }
+    return pi;
+}
+
+std::vector<std::size_t> KMPMatcher(std::string_view T, std::string_view P) {
+    const std::size_t n = T.length();
+    const std::size_t m = P.length();
+    std::vector<std::size_t> res;
+    if (n < m) {
+        return res;
+    }
+    auto pi = ComputePrefixFunction(P);
+    std::size_t q = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        while (q && P[q] != T[i]) {
+            q = pi[q];
+        }
+        if (P[q] == T[i]) {
+            q++;
+        }
+        if (q == m) {
+            res.push_back((i + 1) - m);
+            q = pi[q];
+        }
+    }
+    return res;
+}
+
+// automaton over all 256 byte values, built from the prefix function as in 32.4-8
+std::vector<std::size_t> FiniteAutomatonMatcher(std::string_view T, std::string_view P) {
+    constexpr std::size_t num_chars = 256;
+    const std::size_t n = T.length();
+    const std::size_t m = P.length();
+    std::vector<std::size_t> res;
+    if (n < m) {
+        return res;
+    }
+    auto pi = ComputePrefixFunction(P);
+    std::vector<std::uint32_t> delta (num_chars * (m + 1));
+    for (std::size_t s = 0; s <= m; s++) {
+        for (std::size_t c = 0; c < num_chars; c++) {
+            if (s < m && static_cast<unsigned char>(P[s]) == c) {
+                delta[s * num_chars + c] = static_cast<std::uint32_t>(s + 1);
+            } else if (s) {
+                delta[s * num_chars + c] = delta[pi[s] * num_chars + c];
+            }
+        }
+    }
+    std::uint32_t q = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        q = delta[q * num_chars + static_cast<unsigned char>(T[i])];
+        if (q == m) {
+            res.push_back((i + 1) - m);
+        }
+    }
+    return res;
+}
+
+std::vector<std::size_t> RabinKarpMatcher(std::string_view T, std::string_view P) {
+    constexpr std::size_t d = 256;
+    constexpr std::size_t q = 1'000'000'007;
+    assert(!P.empty());
+    const std::size_t n = T.length();
+    const std::size_t m = P.length();
+    std::vector<std::size_t> res;
+    if (n < m) {
+        return res;
+    }
+    std::size_t h = 1;
+    for (std::size_t i = 1; i < m; i++) {
+        h = (h * d) % q;
+    }
+    std::size_t p = 0;
+    std::size_t t = 0;
+    for (std::size_t i = 0; i < m; i++) {
+        p = (d * p + static_cast<unsigned char>(P[i])) % q;
+        t = (d * t + static_cast<unsigned char>(T[i])) % q;
+    }
+    for (std::size_t s = 0; s <= n - m; s++) {
+        if (p == t && P == T.substr(s, m)) {
+            res.push_back(s);
+        }
+        if (s < n - m) {
+            t = (d * (t + q - (static_cast<unsigned char>(T[s]) * h) % q) + static_cast<unsigned char>(T[s + m])) % q;
+        }
+    }
+    return res;
+}
+
+// bit j is set iff T[s + j] == P[0] and T[s + j + m - 1] == P[m - 1], for the
+// simd_width shifts starting at s. requires s + m - 1 + simd_width <= n.
+#if defined(__AVX512BW__)
+constexpr std::size_t simd_width = 64;
+
+std::uint64_t CandidateMask(const char* first, const char* last, char p0, char p1) {
+    const __m512i f = _mm512_loadu_si512(first);
+    const __m512i l = _mm512_loadu_si512(last);
+    return _mm512_cmpeq_epi8_mask(f, _mm512_set1_epi8(p0)) & _mm512_cmpeq_epi8_mask(l, _mm512_set1_epi8(p1));
+}
+#elif defined(__AVX2__)
+constexpr std::size_t simd_width = 32;
+
+std::uint64_t CandidateMask(const char* first, const char* last, char p0, char p1) {
+    const __m256i f = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+    const __m256i l = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(last));
+    const __m256i eq = _mm256_and_si256(_mm256_cmpeq_epi8(f, _mm256_set1_epi8(p0)),
+                                        _mm256_cmpeq_epi8(l, _mm256_set1_epi8(p1)));
+    return static_cast<std::uint32_t>(_mm256_movemask_epi8(eq));
+}
+#elif defined(__SSE2__)
+constexpr std::size_t simd_width = 16;
+
+std::uint64_t CandidateMask(const char* first, const char* last, char p0, char p1) {
+    const __m128i f = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+    const __m128i l = _mm_loadu_si128(reinterpret_cast<const __m128i*>(last));
+    const __m128i eq = _mm_and_si128(_mm_cmpeq_epi8(f, _mm_set1_epi8(p0)),
+                                     _mm_cmpeq_epi8(l, _mm_set1_epi8(p1)));
+    return static_cast<std::uint32_t>(_mm_movemask_epi8(eq));
+}
+#else
+constexpr std::size_t simd_width = 8;
+
+// portable fallback for targets without SSE2
+std::uint64_t CandidateMask(const char* first, const char* last, char p0, char p1) {
+    std::uint64_t mask = 0;
+    for (std::size_t j = 0; j < simd_width; j++) {
+        mask |= static_cast<std::uint64_t>(first[j] == p0 && last[j] == p1) << j;
+    }
+    return mask;
+}
+#endif
+
+// the pattern's first and last bytes are compared at simd_width shifts per step,
+// and only shifts passing both are verified with memcmp.
+std::vector<std::size_t> SimdStringMatcher(std::string_view T, std::string_view P) {
+    assert(!T.empty() && !P.empty());
+    const std::size_t n = T.length();
+    const std::size_t m = P.length();
+    std::vector<std::size_t> res;
+    if (n < m) {
+        return res;
+    }
+    const char* t = T.data();
+    const char* p = P.data();
+    const char p0 = P[0];
+    const char p1 = P[m - 1];
+    std::size_t s = 0;
+    for (; s + m - 1 + simd_width <= n; s += simd_width) {
+        std::uint64_t mask = CandidateMask(t + s, t + s + m - 1, p0, p1);
+        while (mask) {
+            const std::size_t j = s + std::countr_zero(mask);
+            if (m <= 2 || !std::memcmp(t + j + 1, p + 1, m - 2)) {
+                res.push_back(j);
+            }
+            mask &= mask - 1;
+        }
+    }
+    for (; s <= n - m; s++) {
+        if (t[s] == p0 && t[s + m - 1] == p1 && !std::memcmp(t + s, p, m)) {
+            res.push_back(s);
+        }
+    }
+    return res;
+}
+
+// read-only mapping of a whole file
+class MappedFile {
+    void* data = nullptr;
+    std::size_t length = 0;
+
+public:
+    explicit MappedFile(const fs::path& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("cannot open " + path.string());
+        }
+        struct stat st {};
+        if (::fstat(fd, &st) < 0) {
+            ::close(fd);
+            throw std::runtime_error("cannot stat " + path.string());
+        }
+        length = static_cast<std::size_t>(st.st_size);
+        if (length) {
+            data = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("cannot map " + path.string());
+            }
+            ::madvise(data, length, MADV_SEQUENTIAL);
+        }
+        ::close(fd);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+        if (data) {
+            ::munmap(data, length);
+        }
+    }
+
+    [[nodiscard]] std::string_view View() const {
+        return {static_cast<const char*>(data), length};
+    }
+};
+
+// the n - m + 1 shifts are split into one contiguous range per thread. the range [lo, hi)
+// needs the text T[lo .. hi + m - 1), so neighbouring slices overlap by m - 1 bytes, and
+// each shift is owned by exactly one range: results concatenate in order with no duplicates.
+// slices are shorter than min_chunk only when there is a single one.
+template <typename Matcher>
+std::vector<std::size_t> ParallelMatcher(std::string_view T, std::string_view P, Matcher matcher,
+        std::size_t num_threads = std::thread::hardware_concurrency(), std::size_t min_chunk = std::size_t {1} << 16) {
+    assert(!P.empty());
+    const std::size_t n = T.length();
+    const std::size_t m = P.length();
+    if (n < m) {
+        return {};
+    }
+    const std::size_t shifts = n - m + 1;
+    num_threads = std::clamp<std::size_t>(num_threads, 1, (shifts + min_chunk - 1) / min_chunk);
+    const std::size_t chunk = (shifts + num_threads - 1) / num_threads;
+    std::vector<std::vector<std::size_t>> partial (num_threads);
+    auto worker = [&](std::size_t t) {
+        const std::size_t lo = t * chunk;
+        const std::size_t hi = std::min(shifts, lo + chunk);
+        if (lo >= hi) {
+            return;
+        }
+        partial[t] = matcher(T.substr(lo, hi - lo + m - 1), P);
+        for (auto& s : partial[t]) {
+            s += lo;
+        }
+    };
+    {
+        std::vector<std::jthread> threads;
+        for (std::size_t t = 1; t < num_threads; t++) {
+            threads.emplace_back(worker, t);
+        }
+        worker(0);
+    }
+    if (num_threads == 1) {
+        return std::move(partial[0]);
+    }
+    std::size_t total = 0;
+    for (const auto& r : partial) {
+        total += r.size();
+    }
+    std::vector<std::size_t> res;
+    res.reserve(total);
+    for (const auto& r : partial) {
+        res.insert(res.end(), r.begin(), r.end());
+    }
+    return res;
+}
+
+// corpora larger than memory are mapped rather than read; pages are faulted in by the
+// thread that scans them
+template <typename Matcher>
+std::vector<std::size_t> ParallelScanFile(const fs::path& path, std::string_view P, Matcher matcher,
+        std::size_t num_threads = std::thread::hardware_concurrency()) {
+    MappedFile file (path);
+    return ParallelMatcher(file.View(), P, matcher, num_threads);
+}
+
+int main() {
+    auto res = ParallelMatcher("acaabcaab", "aab", KMPMatcher, 3, 1);
+    for (auto shift : res) {
+        std::cout << shift << ' ';
+    }
+    std::cout << '\n';
+
+    std::mt19937 gen(std::random_device{}());
+    auto random_string = [&gen](std::size_t len, char lo, char hi) {
+        std::uniform_int_distribution<> dist(lo, hi);
+        std::string s (len, ' ');
+        for (auto& c : s) {
+            c = static_cast<char>(dist(gen));
+        }
+        return s;
+    };
+    for (std::size_t iter = 0; iter < 500; iter++) {
+        auto T = random_string(1 + gen() % 500, 'a', 'c');
+        auto P = random_string(1 + gen() % 6, 'a', 'c');
+        auto expected = KMPMatcher(T, P);
+        const std::size_t threads = 1 + gen() % 8;
+        const std::size_t min_chunk = 1 + gen() % 40;
+        assert(ParallelMatcher(T, P, KMPMatcher, threads, min_chunk) == expected);
+        assert(ParallelMatcher(T, P, FiniteAutomatonMatcher, threads, min_chunk) == expected);
+        assert(ParallelMatcher(T, P, RabinKarpMatcher, threads, min_chunk) == expected);
+        assert(ParallelMatcher(T, P, SimdStringMatcher, threads, min_chunk) == expected);
+    }
+
+    // 64 MiB file, with occurrences planted across every slice boundary
+    const auto path = fs::temp_directory_path() / "parallel_matcher_test.txt";
+    const std::size_t num_threads = std::max(4u, std::thread::hardware_concurrency());
+    std::string T = random_string(std::size_t {1} << 26, ' ', '~');
+    const std::string P = "connection reset";
+    const std::size_t chunk = (T.length() - P.length() + 1 + num_threads - 1) / num_threads;
+    for (std::size_t t = 1; t < num_threads; t++) {
+        T.replace(t * chunk - 5, P.length(), P);
+    }
+    {
+        std::ofstream out (path, std::ios::binary);
+        out.write(T.data(), static_cast<std::streamsize>(T.size()));
+    }
+    auto expected = KMPMatcher(T, P);
+    T.clear();
+    T.shrink_to_fit();
+    assert(expected.size() >= num_threads - 1);
+
+    auto bench = [&](const char* name, auto matcher) {
+        auto t1 = crn::steady_clock::now();
+        auto r1 = ParallelScanFile(path, P, matcher, 1);
+        auto t2 = crn::steady_clock::now();
+        auto r2 = ParallelScanFile(path, P, matcher, num_threads);
+        auto t3 = crn::steady_clock::now();
+        assert(r1 == expected && r2 == expected);
+        std::cout << name << ", 1 thread : " << crn::duration_cast<crn::milliseconds>(t2 - t1).count() << "ms, "
+                  << num_threads << " threads : " << crn::duration_cast<crn::milliseconds>(t3 - t2).count() << "ms\n";
+    };
+    bench("KMP", KMPMatcher);
+    bench("Finite automaton", FiniteAutomatonMatcher);
+    bench("Rabin-Karp", RabinKarpMatcher);
+    bench("SIMD", SimdStringMatcher);
+    fs::remove(path);
+}
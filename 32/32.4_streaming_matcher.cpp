@@ -0,0 +1,347 @@
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace crn = std::chrono;
+namespace fs = std::filesystem;
+
+std::vector<std::size_t> ComputePrefixFunction(std::string_view P) {
+    assert(!P.empty());
+    const std::size_t m = P.length();
+    std::vector<std::size_t> pi(m + 1);
+    std::size_t k = 0;
+    for (std::size_t q = 2; q <= m; q++) {
+        while (k && P[k] != P[q - 1]) {
+            k = pi[k];
+        }
+        if (P[k] == P[q - 1]) {
+            k++;
+        }
+        pi[q] = k;
+    }
+    return pi;
+}
+
+std::vector<std::size_t> KMPMatcher(const std::string& T, const std::string& P) {
+    const std::size_t n = T.length();
+    const std::size_t m = P.length();
+    std::vector<std::size_t> res;
+    if (n < m) {
+        return res;
+    }
+    auto pi = ComputePrefixFunction(P);
+    std::size_t q = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        while (q && P[q] != T[i]) {
+            q = pi[q];
+        }
+        if (P[q] == T[i]) {
+            q++;
+        }
+        if (q == m) {
+            res.push_back((i + 1) - m);
+            q = pi[q];
+        }
+    }
+    return res;
+}
+
+// the matchers below are fed successive chunks of one text. matches that straddle chunk
+// boundaries are found because all state lives in the matcher, and shifts are absolute
+// offsets into the whole stream. chunks are only read, never copied.
+
+class StreamingKMPMatcher {
+    std::string P;
+    std::vector<std::size_t> pi;
+    std::size_t q = 0;
+    std::size_t offset = 0; // bytes consumed so far
+
+public:
+    explicit StreamingKMPMatcher(std::string pattern) : P {std::move(pattern)}, pi {ComputePrefixFunction(P)} {}
+
+    template <typename F>
+    void Feed(std::string_view chunk, F&& on_match) {
+        const std::size_t m = P.length();
+        for (std::size_t i = 0; i < chunk.length(); i++) {
+            while (q && P[q] != chunk[i]) {
+                q = pi[q];
+            }
+            if (P[q] == chunk[i]) {
+                q++;
+            }
+            if (q == m) {
+                on_match(offset + i + 1 - m);
+                q = pi[q];
+            }
+        }
+        offset += chunk.length();
+    }
+
+    std::vector<std::size_t> Feed(std::string_view chunk) {
+        std::vector<std::size_t> res;
+        Feed(chunk, [&res](std::size_t s) { res.push_back(s); });
+        return res;
+    }
+
+    void Reset() {
+        q = 0;
+        offset = 0;
+    }
+};
+
+// automaton over all 256 byte values, built from the prefix function as in 32.4-8
+class StreamingFiniteAutomatonMatcher {
+    static constexpr std::size_t num_chars = 256;
+
+    std::size_t m = 0;
+    std::vector<std::uint32_t> delta;
+    std::uint32_t q = 0;
+    std::size_t offset = 0;
+
+public:
+    explicit StreamingFiniteAutomatonMatcher(std::string_view P) : m {P.length()}, delta (num_chars * (P.length() + 1)) {
+        auto pi = ComputePrefixFunction(P);
+        for (std::size_t s = 0; s <= m; s++) {
+            for (std::size_t c = 0; c < num_chars; c++) {
+                if (s < m && static_cast<unsigned char>(P[s]) == c) {
+                    delta[s * num_chars + c] = static_cast<std::uint32_t>(s + 1);
+                } else if (s) {
+                    delta[s * num_chars + c] = delta[pi[s] * num_chars + c];
+                }
+            }
+        }
+    }
+
+    template <typename F>
+    void Feed(std::string_view chunk, F&& on_match) {
+        for (std::size_t i = 0; i < chunk.length(); i++) {
+            q = delta[q * num_chars + static_cast<unsigned char>(chunk[i])];
+            if (q == m) {
+                on_match(offset + i + 1 - m);
+            }
+        }
+        offset += chunk.length();
+    }
+
+    std::vector<std::size_t> Feed(std::string_view chunk) {
+        std::vector<std::size_t> res;
+        Feed(chunk, [&res](std::size_t s) { res.push_back(s); });
+        return res;
+    }
+
+    void Reset() {
+        q = 0;
+        offset = 0;
+    }
+};
+
+// the rolling hash needs the byte that leaves the window, which may belong to an earlier
+// chunk, so the last m bytes are kept in a ring of fixed size m.
+class StreamingRabinKarpMatcher {
+    static constexpr std::size_t d = 256;
+    static constexpr std::size_t q = 1'000'000'007;
+
+    std::string P;
+    std::size_t h = 1; // d^(m - 1) mod q
+    std::size_t p = 0;
+    std::size_t t = 0;
+    std::string window;
+    std::size_t pos = 0; // oldest byte of the window
+    std::size_t offset = 0;
+
+    [[nodiscard]] bool WindowEquals() const {
+        const std::size_t m = P.length();
+        return !std::memcmp(window.data() + pos, P.data(), m - pos) &&
+               !std::memcmp(window.data(), P.data() + (m - pos), pos);
+    }
+
+public:
+    explicit StreamingRabinKarpMatcher(std::string pattern) : P {std::move(pattern)}, window (P.length(), '\0') {
+        assert(!P.empty());
+        for (std::size_t i = 1; i < P.length(); i++) {
+            h = (h * d) % q;
+        }
+        for (unsigned char c : P) {
+            p = (d * p + c) % q;
+        }
+    }
+
+    template <typename F>
+    void Feed(std::string_view chunk, F&& on_match) {
+        const std::size_t m = P.length();
+        for (std::size_t i = 0; i < chunk.length(); i++) {
+            const auto in = static_cast<unsigned char>(chunk[i]);
+            if (offset + i >= m) {
+                const auto out = static_cast<unsigned char>(window[pos]);
+                t = (t + q - (out * h) % q) % q;
+            }
+            t = (d * t + in) % q;
+            window[pos] = static_cast<char>(in);
+            pos = (pos + 1 == m) ? 0 : pos + 1;
+            if (offset + i + 1 >= m && t == p && WindowEquals()) {
+                on_match(offset + i + 1 - m);
+            }
+        }
+        offset += chunk.length();
+    }
+
+    std::vector<std::size_t> Feed(std::string_view chunk) {
+        std::vector<std::size_t> res;
+        Feed(chunk, [&res](std::size_t s) { res.push_back(s); });
+        return res;
+    }
+
+    void Reset() {
+        t = 0;
+        pos = 0;
+        offset = 0;
+    }
+};
+
+// read-only mapping of a whole file
+class MappedFile {
+    void* data = nullptr;
+    std::size_t length = 0;
+
+public:
+    explicit MappedFile(const fs::path& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("cannot open " + path.string());
+        }
+        struct stat st {};
+        if (::fstat(fd, &st) < 0) {
+            ::close(fd);
+            throw std::runtime_error("cannot stat " + path.string());
+        }
+        length = static_cast<std::size_t>(st.st_size);
+        if (length) {
+            data = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("cannot map " + path.string());
+            }
+            ::madvise(data, length, MADV_SEQUENTIAL);
+        }
+        ::close(fd);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+        if (data) {
+            ::munmap(data, length);
+        }
+    }
+
+    [[nodiscard]] std::string_view View() const {
+        return {static_cast<const char*>(data), length};
+    }
+};
+
+// feeds a mapped file to a matcher in slices of chunk_size bytes
+template <typename Matcher>
+std::vector<std::size_t> ScanFile(const fs::path& path, Matcher& matcher, std::size_t chunk_size = std::size_t {1} << 20) {
+    MappedFile file (path);
+    auto text = file.View();
+    std::vector<std::size_t> res;
+    for (std::size_t i = 0; i < text.length(); i += chunk_size) {
+        matcher.Feed(text.substr(i, chunk_size), [&res](std::size_t s) { res.push_back(s); });
+    }
+    return res;
+}
+
+int main() {
+    StreamingKMPMatcher kmp ("aab");
+    std::vector<std::size_t> res;
+    for (std::string_view chunk : {"aca", "a", "bcaa", "b"}) {
+        for (auto s : kmp.Feed(chunk)) {
+            res.push_back(s);
+        }
+    }
+    for (auto shift : res) {
+        std::cout << shift << ' ';
+    }
+    std::cout << '\n';
+
+    std::mt19937 gen(std::random_device{}());
+    std::uniform_int_distribution<> dist('a', 'c');
+    for (std::size_t iter = 0; iter < 500; iter++) {
+        std::string T (1 + gen() % 500, ' ');
+        std::string P (1 + gen() % 5, ' ');
+        for (auto& c : T) {
+            c = static_cast<char>(dist(gen));
+        }
+        for (auto& c : P) {
+            c = static_cast<char>(dist(gen));
+        }
+        auto expected = KMPMatcher(T, P);
+        StreamingKMPMatcher m1 (P);
+        StreamingFiniteAutomatonMatcher m2 (P);
+        StreamingRabinKarpMatcher m3 (P);
+        std::vector<std::size_t> r1, r2, r3;
+        std::string_view T_sv (T);
+        for (std::size_t i = 0; i < T.length();) {
+            std::size_t len = 1 + gen() % 7;
+            auto chunk = T_sv.substr(i, len);
+            m1.Feed(chunk, [&r1](std::size_t s) { r1.push_back(s); });
+            m2.Feed(chunk, [&r2](std::size_t s) { r2.push_back(s); });
+            m3.Feed(chunk, [&r3](std::size_t s) { r3.push_back(s); });
+            i += len;
+        }
+        assert(r1 == expected && r2 == expected && r3 == expected);
+    }
+
+    // 64 MiB file, scanned through a memory mapping
+    const auto path = fs::temp_directory_path() / "streaming_matcher_test.txt";
+    std::string T (std::size_t {1} << 26, ' ');
+    std::uniform_int_distribution<> log_dist(' ', '~');
+    for (auto& c : T) {
+        c = static_cast<char>(log_dist(gen));
+    }
+    const std::string P = "connection reset";
+    for (std::size_t i = 1; i < 64; i++) {
+        T.replace(i * (std::size_t {1} << 20) - 5, P.length(), P); // across slice boundaries
+    }
+    {
+        std::ofstream out (path, std::ios::binary);
+        out.write(T.data(), static_cast<std::streamsize>(T.size()));
+    }
+    auto expected = KMPMatcher(T, P);
+    T.clear();
+    T.shrink_to_fit();
+
+    StreamingKMPMatcher m1 (P);
+    StreamingFiniteAutomatonMatcher m2 (P);
+    StreamingRabinKarpMatcher m3 (P);
+    auto t1 = crn::steady_clock::now();
+    auto r1 = ScanFile(path, m1);
+    auto t2 = crn::steady_clock::now();
+    auto r2 = ScanFile(path, m2);
+    auto t3 = crn::steady_clock::now();
+    auto r3 = ScanFile(path, m3);
+    auto t4 = crn::steady_clock::now();
+    fs::remove(path);
+    assert(r1 == expected && r2 == expected && r3 == expected);
+    std::cout << expected.size() << " matches\n";
+    std::cout << "KMP : " << crn::duration_cast<crn::milliseconds>(t2 - t1).count() << "ms\n";
+    std::cout << "Finite automaton : " << crn::duration_cast<crn::milliseconds>(t3 - t2).count() << "ms\n";
+    std::cout << "Rabin-Karp : " << crn::duration_cast<crn::milliseconds>(t4 - t3).count() << "ms\n";
+}
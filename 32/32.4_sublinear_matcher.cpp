@@ -0,0 +1,340 @@
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace crn = std::chrono;
+
+std::vector<std::size_t> ComputePrefixFunction(std::string_view P) {
+    assert(!P.empty());
+    const std::size_t m = P.length();
+    std::vector<std::size_t> pi(m + 1);
+    std::size_t k = 0;
+    for (std::size_t q = 2; q <= m; q++) {
+        while (k && P[k] != P[q - 1]) {
+            k = pi[k];
+        }
+        if (P[k] == P[q - 1]) {
+            k++;
+        }
+        pi[q] = k;
+    }
+    return pi;
+}
+
+std::vector<std::size_t> KMPMatcher(std::string_view T, std::string_view P) {
+    const std::size_t n = T.length();
+    const std::size_t m = P.length();
+    std::vector<std::size_t> res;
+    if (n < m) {
+        return res;
+    }
+    auto pi = ComputePrefixFunction(P);
+    std::size_t q = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        while (q && P[q] != T[i]) {
+            q = pi[q];
+        }
+        if (P[q] == T[i]) {
+            q++;
+        }
+        if (q == m) {
+            res.push_back((i + 1) - m);
+            q = pi[q];
+        }
+    }
+    return res;
+}
+
+// shift that aligns the rightmost occurrence of c in P[0 .. m - 2] with the window's last byte
+std::array<std::ptrdiff_t, 256> ComputeBadCharacterShift(std::string_view P) {
+    const auto m = static_cast<std::ptrdiff_t>(P.length());
+    std::array<std::ptrdiff_t, 256> bc;
+    bc.fill(m);
+    for (std::ptrdiff_t i = 0; i < m - 1; i++) {
+        bc[static_cast<unsigned char>(P[i])] = m - 1 - i;
+    }
+    return bc;
+}
+
+// suff[i]: length of the longest common suffix of P[0 .. i] and P
+std::vector<std::ptrdiff_t> ComputeSuffixes(std::string_view P) {
+    const auto m = static_cast<std::ptrdiff_t>(P.length());
+    std::vector<std::ptrdiff_t> suff (m);
+    suff[m - 1] = m;
+    std::ptrdiff_t g = m - 1;
+    std::ptrdiff_t f = m - 1;
+    for (std::ptrdiff_t i = m - 2; i >= 0; i--) {
+        if (i > g && suff[i + m - 1 - f] < i - g) {
+            suff[i] = suff[i + m - 1 - f];
+        } else {
+            g = std::min(g, i);
+            f = i;
+            while (g >= 0 && P[g] == P[g + m - 1 - f]) {
+                g--;
+            }
+            suff[i] = f - g;
+        }
+    }
+    return suff;
+}
+
+// gs[i]: shift after a mismatch at P[i] with P[i + 1 .. m - 1] matched, aligning the matched
+// suffix with its rightmost reoccurrence (preceded by a different byte) or with a border of P
+std::vector<std::ptrdiff_t> ComputeGoodSuffixShift(std::string_view P) {
+    const auto m = static_cast<std::ptrdiff_t>(P.length());
+    auto suff = ComputeSuffixes(P);
+    std::vector<std::ptrdiff_t> gs (m, m);
+    std::ptrdiff_t j = 0;
+    for (std::ptrdiff_t i = m - 1; i >= -1; i--) {
+        if (i == -1 || suff[i] == i + 1) {
+            for (; j < m - 1 - i; j++) {
+                if (gs[j] == m) {
+                    gs[j] = m - 1 - i;
+                }
+            }
+        }
+    }
+    for (std::ptrdiff_t i = 0; i <= m - 2; i++) {
+        gs[m - 1 - suff[i]] = m - 1 - i;
+    }
+    return gs;
+}
+
+std::vector<std::size_t> BoyerMooreMatcher(std::string_view T, std::string_view P) {
+    assert(!P.empty());
+    const auto n = static_cast<std::ptrdiff_t>(T.length());
+    const auto m = static_cast<std::ptrdiff_t>(P.length());
+    std::vector<std::size_t> res;
+    if (n < m) {
+        return res;
+    }
+    auto bc = ComputeBadCharacterShift(P);
+    auto gs = ComputeGoodSuffixShift(P);
+    std::ptrdiff_t s = 0;
+    while (s <= n - m) {
+        std::ptrdiff_t i = m - 1;
+        while (i >= 0 && P[i] == T[s + i]) {
+            i--;
+        }
+        if (i < 0) {
+            res.push_back(static_cast<std::size_t>(s));
+            s += gs[0];
+        } else {
+            s += std::max(gs[i], bc[static_cast<unsigned char>(T[s + i])] - m + 1 + i);
+        }
+    }
+    return res;
+}
+
+// bad-character rule alone, always keyed on the window's last byte
+std::vector<std::size_t> HorspoolMatcher(std::string_view T, std::string_view P) {
+    assert(!P.empty());
+    const std::size_t n = T.length();
+    const std::size_t m = P.length();
+    std::vector<std::size_t> res;
+    if (n < m) {
+        return res;
+    }
+    auto bc = ComputeBadCharacterShift(P);
+    const char last = P[m - 1];
+    std::size_t s = 0;
+    while (s <= n - m) {
+        const char c = T[s + m - 1];
+        if (c == last && !std::memcmp(T.data() + s, P.data(), m - 1)) {
+            res.push_back(s);
+        }
+        s += static_cast<std::size_t>(bc[static_cast<unsigned char>(c)]);
+    }
+    return res;
+}
+
+// start of the lexicographically maximal suffix of P under < (or > if reversed), and its period
+std::pair<std::ptrdiff_t, std::ptrdiff_t> MaximalSuffix(std::string_view P, bool reversed) {
+    const auto m = static_cast<std::ptrdiff_t>(P.length());
+    std::ptrdiff_t ms = -1;
+    std::ptrdiff_t j = 0;
+    std::ptrdiff_t k = 1;
+    std::ptrdiff_t p = 1;
+    while (j + k < m) {
+        const auto a = static_cast<unsigned char>(P[j + k]);
+        const auto b = static_cast<unsigned char>(P[ms + k]);
+        if (reversed ? a > b : a < b) {
+            j += k;
+            k = 1;
+            p = j - ms;
+        } else if (a == b) {
+            if (k != p) {
+                k++;
+            } else {
+                j += p;
+                k = 1;
+            }
+        } else {
+            ms = j;
+            j = ms + 1;
+            k = p = 1;
+        }
+    }
+    return {ms, p};
+}
+
+// Crochemore and Perrin. P = P[0 .. ell] P[ell + 1 .. m) is a critical factorization: the right
+// part is scanned left to right, then the left part right to left. O(n + m) time and O(1) space.
+std::vector<std::size_t> TwoWayMatcher(std::string_view T, std::string_view P) {
+    assert(!P.empty());
+    const auto n = static_cast<std::ptrdiff_t>(T.length());
+    const auto m = static_cast<std::ptrdiff_t>(P.length());
+    std::vector<std::size_t> res;
+    if (n < m) {
+        return res;
+    }
+    auto [i1, p1] = MaximalSuffix(P, false);
+    auto [i2, p2] = MaximalSuffix(P, true);
+    const std::ptrdiff_t ell = i1 > i2 ? i1 : i2;
+    std::ptrdiff_t per = i1 > i2 ? p1 : p2;
+    std::ptrdiff_t s = 0;
+    if (!std::memcmp(P.data(), P.data() + per, static_cast<std::size_t>(ell + 1))) {
+        // P has period per: the prefix matched at the previous shift need not be rescanned
+        std::ptrdiff_t memory = -1;
+        while (s <= n - m) {
+            std::ptrdiff_t i = std::max(ell, memory) + 1;
+            while (i < m && P[i] == T[s + i]) {
+                i++;
+            }
+            if (i >= m) {
+                i = ell;
+                while (i > memory && P[i] == T[s + i]) {
+                    i--;
+                }
+                if (i <= memory) {
+                    res.push_back(static_cast<std::size_t>(s));
+                }
+                s += per;
+                memory = m - per - 1;
+            } else {
+                s += i - ell;
+                memory = -1;
+            }
+        }
+    } else {
+        per = std::max(ell + 1, m - ell - 1) + 1;
+        while (s <= n - m) {
+            std::ptrdiff_t i = ell + 1;
+            while (i < m && P[i] == T[s + i]) {
+                i++;
+            }
+            if (i >= m) {
+                i = ell;
+                while (i >= 0 && P[i] == T[s + i]) {
+                    i--;
+                }
+                if (i < 0) {
+                    res.push_back(static_cast<std::size_t>(s));
+                }
+                s += per;
+            } else {
+                s += i - ell;
+            }
+        }
+    }
+    return res;
+}
+
+enum class MatcherKind {
+    Horspool,
+    BoyerMoore,
+    TwoWay,
+};
+
+// distinct bytes among the first sample_size bytes of T
+std::size_t EstimateAlphabetSize(std::string_view T, std::size_t sample_size = 4096) {
+    std::array<bool, 256> seen {};
+    std::size_t sigma = 0;
+    for (unsigned char c : T.substr(0, sample_size)) {
+        sigma += !seen[c];
+        seen[c] = true;
+    }
+    return sigma;
+}
+
+// bad-character shifts average about min(m, sigma), which already beats one linear pass from
+// four distinct bytes on. long patterns over small alphabets repeat their suffixes, where the
+// good-suffix rule keeps Boyer-Moore from falling back to short shifts. over one or two
+// distinct bytes neither skips much, and Two-Way stays linear in the worst case.
+MatcherKind SelectMatcher(std::size_t m, std::size_t sigma) {
+    if (sigma <= 2) {
+        return MatcherKind::TwoWay;
+    }
+    if (m >= 32 && sigma < 16) {
+        return MatcherKind::BoyerMoore;
+    }
+    return MatcherKind::Horspool;
+}
+
+std::vector<std::size_t> SublinearMatcher(std::string_view T, std::string_view P) {
+    switch (SelectMatcher(P.length(), EstimateAlphabetSize(T))) {
+        case MatcherKind::Horspool: return HorspoolMatcher(T, P);
+        case MatcherKind::BoyerMoore: return BoyerMooreMatcher(T, P);
+        case MatcherKind::TwoWay: return TwoWayMatcher(T, P);
+    }
+    return {};
+}
+
+int main() {
+    for (auto shift : BoyerMooreMatcher("acaabcaab", "aab")) {
+        std::cout << shift << ' ';
+    }
+    std::cout << '\n';
+
+    std::mt19937 gen(std::random_device{}());
+    auto random_string = [&gen](std::size_t len, char lo, char hi) {
+        std::uniform_int_distribution<> dist(lo, hi);
+        std::string s (len, ' ');
+        for (auto& c : s) {
+            c = static_cast<char>(dist(gen));
+        }
+        return s;
+    };
+    for (std::size_t iter = 0; iter < 2'000; iter++) {
+        const char hi = iter % 3 ? 'b' : 'd';
+        auto T = random_string(gen() % 500, 'a', hi);
+        auto P = random_string(1 + gen() % 10, 'a', hi);
+        auto expected = KMPMatcher(T, P);
+        assert(BoyerMooreMatcher(T, P) == expected);
+        assert(HorspoolMatcher(T, P) == expected);
+        assert(TwoWayMatcher(T, P) == expected);
+        assert(SublinearMatcher(T, P) == expected);
+    }
+
+    auto bench = [](const char* name, std::string_view T, std::string_view P) {
+        std::cout << name << ", m = " << P.length() << ", sigma = " << EstimateAlphabetSize(T) << '\n';
+        auto expected = KMPMatcher(T, P);
+        auto run = [&](const char* algo, auto matcher) {
+            auto t1 = crn::steady_clock::now();
+            auto r = matcher(T, P);
+            auto t2 = crn::steady_clock::now();
+            assert(r == expected);
+            std::cout << "  " << algo << " : " << crn::duration_cast<crn::milliseconds>(t2 - t1).count() << "ms\n";
+        };
+        run("KMP", KMPMatcher);
+        run("Horspool", HorspoolMatcher);
+        run("Boyer-Moore", BoyerMooreMatcher);
+        run("Two-Way", TwoWayMatcher);
+        run("Selected", SublinearMatcher);
+    };
+    auto text = random_string(std::size_t {1} << 26, 'a', 'z');
+    bench("English-like", text, text.substr(12345, 32));
+    auto dna = random_string(std::size_t {1} << 26, 'a', 'd');
+    bench("DNA-like", dna, dna.substr(12345, 64));
+    bench("DNA-like", dna, dna.substr(12345, 8));
+    std::string periodic (std::size_t {1} << 26, 'a');
+    bench("Periodic", periodic, std::string(1000, 'a') + 'b');
+}
@@ -0,0 +1,175 @@
+#include <algorithm>
+#include <barrier>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace crn = std::chrono;
+
+std::size_t Knapsack(const std::vector<std::pair<std::size_t, std::size_t>>& items, std::size_t W) {
+    assert(W > 0 && !items.empty());
+    const std::size_t n = items.size();
+    std::vector<std::vector<std::size_t>> m (n + 1, std::vector<std::size_t>(W + 1));
+    for (std::size_t i = 1; i <= n; i++) {
+        for (std::size_t j = 0; j <= W; j++) {
+            if (items[i - 1].first > j) {
+                m[i][j] = m[i - 1][j];
+            } else {
+                m[i][j] = std::max(m[i - 1][j], m[i - 1][j - items[i - 1].first] + items[i - 1].second);
+            }
+        }
+    }
+    return m[n][W];
+}
+
+// the same DP on one row, updated in place from the largest capacity down
+std::size_t KnapsackRow(const std::vector<std::pair<std::size_t, std::size_t>>& items, std::size_t W) {
+    std::vector<std::size_t> m (W + 1);
+    for (const auto& [w, v] : items) {
+        for (std::size_t j = W + 1; j-- > w;) {
+            m[j] = std::max(m[j], m[j - w] + v);
+        }
+    }
+    return m[W];
+}
+
+constexpr std::size_t block = 16; // capacities per fixed-length inner loop, so gcc vectorizes it at -O2
+
+// one item as a max-plus shift: next[c] = max(curr[c], curr[c - w] + v) for c in [a, b), a >= w
+template <typename V>
+void MaxPlus(const V* __restrict curr, V* __restrict next, std::size_t w, V v, std::size_t a, std::size_t b) {
+    std::size_t c = a;
+    for (; c + block <= b; c += block) {
+        for (std::size_t e = 0; e < block; e++) {
+            next[c + e] = std::max(curr[c + e], curr[c + e - w] + v);
+        }
+    }
+    for (; c < b; c++) {
+        next[c] = std::max(curr[c], curr[c - w] + v);
+    }
+}
+
+// row DP of Knapsack with the capacities of every item sliced across threads. rows are double
+// buffered so slices read only the previous row, and only capacities up to the total weight so
+// far are computed; beyond it the row is flat.
+template <typename V>
+std::size_t SlicedKnapsack(const std::vector<std::pair<std::size_t, std::size_t>>& items, std::size_t W,
+                           std::size_t num_threads) {
+    std::vector<V> curr (W + 1), next (W + 1);
+    std::size_t reach = 0; // capacities [0, reach] of curr are up to date
+    std::size_t item = 0;
+    std::size_t hi = items.empty() ? 0 : std::min(W, items[0].first);
+    std::barrier sync (static_cast<std::ptrdiff_t>(num_threads), [&]() noexcept {
+        std::swap(curr, next);
+        reach = hi;
+        item++;
+        if (item < items.size()) {
+            hi = std::min(W, reach + items[item].first);
+            std::fill(curr.begin() + static_cast<std::ptrdiff_t>(reach + 1), curr.begin() + static_cast<std::ptrdiff_t>(hi + 1), curr[reach]);
+        }
+    });
+    auto worker = [&](std::size_t id) {
+        while (item < items.size()) {
+            const auto [w, v] = items[item];
+            // slices of whole blocks, so threads do not share cache lines
+            auto bound = [&](std::size_t t) {
+                return t == num_threads ? hi + 1 : (hi + 1) * t / num_threads / block * block;
+            };
+            const std::size_t a = bound(id);
+            const std::size_t b = bound(id + 1);
+            const std::size_t split = std::clamp(w, a, b);
+            std::copy(curr.begin() + static_cast<std::ptrdiff_t>(a), curr.begin() + static_cast<std::ptrdiff_t>(split),
+                      next.begin() + static_cast<std::ptrdiff_t>(a));
+            if (split < b) {
+                MaxPlus(curr.data(), next.data(), w, static_cast<V>(v), split, b);
+            }
+            sync.arrive_and_wait();
+        }
+    };
+    {
+        std::vector<std::jthread> threads;
+        for (std::size_t id = 1; id < num_threads; id++) {
+            threads.emplace_back(worker, id);
+        }
+        worker(0);
+    }
+    return curr[reach];
+}
+
+// items are (weight, value). values run in 32-bit lanes when their total fits, which doubles
+// the lanes per vector
+std::size_t ParallelKnapsack(const std::vector<std::pair<std::size_t, std::size_t>>& items, std::size_t W,
+                             std::size_t num_threads = std::thread::hardware_concurrency()) {
+    num_threads = std::clamp<std::size_t>(num_threads, 1, std::max<std::size_t>(W / 4096, 1));
+    std::vector<std::pair<std::size_t, std::size_t>> usable;
+    std::size_t free = 0;
+    std::size_t total = 0;
+    for (const auto& [w, v] : items) {
+        if (w == 0) {
+            free += v;
+        } else if (w <= W) {
+            usable.emplace_back(w, v);
+            total += v;
+        }
+    }
+    if (total <= std::numeric_limits<std::uint32_t>::max()) {
+        return free + SlicedKnapsack<std::uint32_t>(usable, W, num_threads);
+    }
+    return free + SlicedKnapsack<std::uint64_t>(usable, W, num_threads);
+}
+
+int main() {
+    std::vector<std::pair<std::size_t, std::size_t>> items {
+            {23, 505}, {26, 352}, {20, 458}, {18, 220},
+            {32, 354}, {27, 414}, {29, 498}, {26, 545},
+            {30, 473}, {27, 543},
+    };
+
+    constexpr std::size_t W = 67;
+
+    auto knapsack = Knapsack(items, W);
+    auto parallel_knapsack = ParallelKnapsack(items, W);
+    std::cout << knapsack << ' ' << parallel_knapsack << '\n';
+    assert(knapsack == parallel_knapsack);
+
+    std::mt19937 gen(std::random_device{}());
+    for (std::size_t iter = 0; iter < 300; iter++) {
+        items.resize(1 + gen() % 40);
+        const std::size_t max_value = iter % 4 ? 1000 : std::size_t {1} << 40; // 64-bit lanes
+        for (auto& [w, v] : items) {
+            w = gen() % 3000;
+            v = std::uniform_int_distribution<std::size_t>(0, max_value)(gen);
+        }
+        const std::size_t capacity = 1 + gen() % 20000;
+        const auto expected = Knapsack(items, capacity);
+        for (std::size_t threads : {1, 2, 3}) {
+            assert(ParallelKnapsack(items, capacity, threads) == expected);
+        }
+    }
+
+    // a thousand items against a capacity of a million
+    items.resize(1000);
+    for (auto& [w, v] : items) {
+        w = 1 + gen() % 20000;
+        v = 1 + gen() % 100000;
+    }
+    const std::size_t capacity = 1'000'000;
+    auto t1 = crn::steady_clock::now();
+    auto expected = KnapsackRow(items, capacity);
+    auto t2 = crn::steady_clock::now();
+    auto res = ParallelKnapsack(items, capacity, 1);
+    auto t3 = crn::steady_clock::now();
+    auto parallel = ParallelKnapsack(items, capacity, 4);
+    auto t4 = crn::steady_clock::now();
+    assert(res == expected && parallel == expected);
+    std::cout << "Best value " << expected << '\n';
+    std::cout << "Row DP : " << crn::duration_cast<crn::milliseconds>(t2 - t1).count() << "ms\n";
+    std::cout << "Max-plus rows : " << crn::duration_cast<crn::milliseconds>(t3 - t2).count() << "ms\n";
+    std::cout << "Max-plus rows on 4 threads : " << crn::duration_cast<crn::milliseconds>(t4 - t3).count() << "ms\n";
+}
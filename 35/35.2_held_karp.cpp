@@ -0,0 +1,500 @@
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace crn = std::chrono;
+
+using Point = std::pair<double, double>;
+
+double distance(const Point& p1, const Point& p2) {
+    return std::hypot(p1.first - p2.first, p1.second - p2.second);
+}
+
+// dense symmetric distance matrix
+struct Distances {
+    size_t n = 0;
+    std::vector<double> d;
+
+    explicit Distances(const std::vector<Point>& p) : n {p.size()}, d (n * n) {
+        for (size_t i = 0; i < n; i++) {
+            for (size_t j = 0; j < n; j++) {
+                d[i * n + j] = distance(p[i], p[j]);
+            }
+        }
+    }
+
+    double operator()(size_t i, size_t j) const {
+        return d[i * n + j];
+    }
+};
+
+struct Tour {
+    std::vector<size_t> order; // starts at 0
+    double length = 0;
+};
+
+double TourLength(const Distances& d, const std::vector<size_t>& order) {
+    double res = 0;
+    for (size_t i = 0; i < order.size(); i++) {
+        res += d(order[i], order[(i + 1) % order.size()]);
+    }
+    return res;
+}
+
+// MSTPrim of 35.2 on a dense graph: an array instead of a heap, O(V^2)
+std::vector<size_t> MSTPrim(const Distances& d, size_t r) {
+    const size_t n = d.n;
+    std::vector<size_t> parent (n, r);
+    std::vector<double> key (n, std::numeric_limits<double>::max());
+    std::vector<bool> done (n);
+    key[r] = 0;
+    for (size_t round = 0; round < n; round++) {
+        size_t u = n;
+        for (size_t v = 0; v < n; v++) {
+            if (!done[v] && (u == n || key[v] < key[u])) {
+                u = v;
+            }
+        }
+        done[u] = true;
+        for (size_t v = 0; v < n; v++) {
+            if (!done[v] && d(u, v) < key[v]) {
+                key[v] = d(u, v);
+                parent[v] = u;
+            }
+        }
+    }
+    return parent;
+}
+
+// weight of the minimum spanning tree over the cities in mask, bit i for city i + 1
+double MSTWeight(const Distances& d, std::uint32_t mask) {
+    size_t cities[32];
+    double key[32];
+    size_t k = 0;
+    for (auto m = mask; m; m &= m - 1) {
+        cities[k] = static_cast<size_t>(std::countr_zero(m)) + 1;
+        key[k] = std::numeric_limits<double>::max();
+        k++;
+    }
+    double res = 0;
+    size_t c = k ? cities[--k] : 0;
+    while (k) {
+        for (size_t i = 0; i < k; i++) {
+            key[i] = std::min(key[i], d(c, cities[i]));
+        }
+        size_t u = 0;
+        for (size_t i = 1; i < k; i++) {
+            if (key[i] < key[u]) {
+                u = i;
+            }
+        }
+        res += key[u];
+        c = cities[u];
+        k--;
+        cities[u] = cities[k];
+        key[u] = key[k];
+    }
+    return res;
+}
+
+// preorder walk of the minimum spanning tree, a 2-approximation for metric distances
+Tour ApproxTSPTour(const Distances& d) {
+    auto parent = MSTPrim(d, 0);
+    std::vector<std::vector<size_t>> children (d.n);
+    for (size_t v = 1; v < d.n; v++) {
+        children[parent[v]].push_back(v);
+    }
+    Tour tour;
+    std::vector<size_t> stack {0};
+    while (!stack.empty()) {
+        const size_t u = stack.back();
+        stack.pop_back();
+        tour.order.push_back(u);
+        stack.insert(stack.end(), children[u].rbegin(), children[u].rend());
+    }
+    tour.length = TourLength(d, tour.order);
+    return tour;
+}
+
+// reverses tour segments while that shortens the tour
+bool TwoOpt(const Distances& d, Tour& tour) {
+    auto& t = tour.order;
+    const size_t n = t.size();
+    bool improved = n > 3;
+    bool any = false;
+    while (improved) {
+        improved = false;
+        for (size_t i = 0; i + 2 < n; i++) {
+            for (size_t j = i + 2; j < n; j++) {
+                const size_t a = t[i], b = t[i + 1], c = t[j], e = t[(j + 1) % n];
+                if (a == e) {
+                    continue;
+                }
+                if (d(a, c) + d(b, e) < d(a, b) + d(c, e) - 1e-9) {
+                    std::reverse(t.begin() + static_cast<std::ptrdiff_t>(i + 1), t.begin() + static_cast<std::ptrdiff_t>(j + 1));
+                    improved = any = true;
+                }
+            }
+        }
+    }
+    tour.length = TourLength(d, t);
+    return any;
+}
+
+// moves segments of up to 3 cities elsewhere in the tour while that shortens it. city 0 stays
+// in front
+bool OrOpt(const Distances& d, Tour& tour) {
+    auto& t = tour.order;
+    const size_t n = t.size();
+    bool any = false;
+    for (bool improved = n > 4; improved;) {
+        improved = false;
+        for (size_t len = 1; len <= 3; len++) {
+            for (size_t i = 1; i + len <= n; i++) {
+                const size_t prev = t[i - 1], first = t[i], last = t[i + len - 1], next = t[(i + len) % n];
+                const double gain = d(prev, first) + d(last, next) - d(prev, next);
+                for (size_t j = 0; j < n; j++) {
+                    if (j + 1 >= i && j < i + len) { // edges touching the segment
+                        continue;
+                    }
+                    const size_t a = t[j], b = t[(j + 1) % n];
+                    const double forward = d(a, first) + d(last, b) - d(a, b);
+                    const double backward = d(a, last) + d(first, b) - d(a, b);
+                    if (std::min(forward, backward) < gain - 1e-9) {
+                        std::vector<size_t> segment (t.begin() + static_cast<std::ptrdiff_t>(i), t.begin() + static_cast<std::ptrdiff_t>(i + len));
+                        if (backward < forward) {
+                            std::reverse(segment.begin(), segment.end());
+                        }
+                        t.erase(t.begin() + static_cast<std::ptrdiff_t>(i), t.begin() + static_cast<std::ptrdiff_t>(i + len));
+                        const size_t at = j < i ? j + 1 : j + 1 - len;
+                        t.insert(t.begin() + static_cast<std::ptrdiff_t>(at), segment.begin(), segment.end());
+                        improved = any = true;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    tour.length = TourLength(d, t);
+    return any;
+}
+
+// ApproxTSPTour, then 2-opt and or-opt from it and from random tours; the best local optimum
+// bounds the exact search
+Tour LocalSearchTour(const Distances& d, size_t restarts = 32) {
+    std::mt19937 gen(42);
+    auto best = ApproxTSPTour(d);
+    for (size_t r = 0; r <= restarts; r++) {
+        Tour tour = best;
+        if (r) {
+            std::shuffle(tour.order.begin() + 1, tour.order.end(), gen);
+        }
+        while (TwoOpt(d, tour) | OrOpt(d, tour)) {
+        }
+        if (tour.length < best.length) {
+            best = tour;
+        }
+    }
+    return best;
+}
+
+// every tour from 0, for checking
+Tour BruteForceTSP(const Distances& d) {
+    std::vector<size_t> order (d.n);
+    std::iota(order.begin(), order.end(), 0);
+    Tour best {order, TourLength(d, order)};
+    while (std::next_permutation(order.begin() + 1, order.end())) {
+        const double length = TourLength(d, order);
+        if (length < best.length) {
+            best = {order, length};
+        }
+    }
+    return best;
+}
+
+// combinatorial number system: the subsets of {0, .., m - 1} with k elements are ranked
+// 0 .. C(m, k) - 1, so every layer of the DP is a flat array
+class SubsetRanks {
+    std::vector<std::vector<std::uint64_t>> C;
+
+public:
+    explicit SubsetRanks(size_t m) : C (m + 1, std::vector<std::uint64_t> (m + 2)) {
+        for (size_t a = 0; a <= m; a++) {
+            C[a][0] = 1;
+            for (size_t b = 1; b <= a; b++) {
+                C[a][b] = C[a - 1][b - 1] + (b < a ? C[a - 1][b] : 0);
+            }
+        }
+    }
+
+    [[nodiscard]] std::uint64_t Count(size_t m, size_t k) const {
+        return C[m][k];
+    }
+
+    [[nodiscard]] std::uint64_t Rank(std::uint32_t mask) const {
+        std::uint64_t res = 0;
+        for (size_t i = 1; mask; mask &= mask - 1, i++) {
+            res += C[static_cast<size_t>(std::countr_zero(mask))][i];
+        }
+        return res;
+    }
+};
+
+// DP entries pack a cost and the previous city into one word: costs are nonnegative, so their
+// bits order like the costs, and the low 5 mantissa bits (a relative error below 1e-14) hold
+// the predecessor. an atomic minimum on the word updates both at once.
+constexpr std::uint64_t pred_bits = 31;
+constexpr std::uint64_t no_entry = std::numeric_limits<std::uint64_t>::max();
+
+std::uint64_t Pack(double cost, size_t pred) {
+    return (std::bit_cast<std::uint64_t>(cost) & ~pred_bits) | pred;
+}
+
+double Unpack(std::uint64_t key) {
+    return std::bit_cast<double>(key & ~pred_bits);
+}
+
+// returns whether this was the first value stored in target
+bool AtomicMin(std::uint64_t& target, std::uint64_t value) {
+    std::atomic_ref<std::uint64_t> ref (target);
+    auto curr = ref.load(std::memory_order_relaxed);
+    while (value < curr) {
+        if (ref.compare_exchange_weak(curr, value, std::memory_order_relaxed)) {
+            return curr == no_entry;
+        }
+    }
+    return false;
+}
+
+template <typename Fn>
+void ParallelFor(size_t count, size_t num_threads, Fn fn) {
+    auto worker = [&](size_t t) {
+        fn(t, count * t / num_threads, count * (t + 1) / num_threads);
+    };
+    std::vector<std::jthread> threads;
+    for (size_t t = 1; t < num_threads; t++) {
+        threads.emplace_back(worker, t);
+    }
+    worker(0);
+}
+
+// Held-Karp over subsets of the cities 1 .. n - 1, one layer per subset size. every layer is a
+// flat array indexed by subset rank and position of the last city, pushed forward by all
+// threads at once; the entries written are then scanned by rank. the rest of a tour from state
+// (S, j) is a path from j through the unvisited cities R back to 0, so it costs at least
+// MST(R) + the cheapest edge from j into R + the cheapest edge from R to 0, and a state of cost
+// c survives only if c plus that bound can still beat the tour from LocalSearchTour. only the
+// survivors are pushed and kept for the traceback, and the array is reset entry by entry, so
+// the work follows the survivors rather than the n 2^n states. prune = false gives the plain
+// O(n^2 2^n) DP. the array has room for the widest layer before pruning, max_k C(n - 1, k) k
+// entries of 8 bytes: about 260 MB at n = 25 and 540 MB at n = 26, the largest size supported.
+Tour HeldKarp(const Distances& d, size_t num_threads = std::thread::hardware_concurrency(), bool prune = true) {
+    const size_t n = d.n;
+    assert(n >= 1 && n <= 26);
+    if (n <= 3) {
+        Tour tour;
+        tour.order.resize(n);
+        std::iota(tour.order.begin(), tour.order.end(), 0);
+        tour.length = TourLength(d, tour.order);
+        return tour;
+    }
+    num_threads = std::clamp<size_t>(num_threads, 1, 64);
+    const size_t m = n - 1;
+    const std::uint32_t all = static_cast<std::uint32_t>((std::uint64_t {1} << m) - 1);
+    const SubsetRanks ranks (m);
+
+    auto upper = prune ? LocalSearchTour(d) : ApproxTSPTour(d);
+    const double bound = prune ? upper.length * (1 + 1e-9) : std::numeric_limits<double>::max();
+
+    struct State {
+        std::uint32_t set;
+        std::uint32_t end; // bit of the last city
+        double cost;
+        std::uint32_t pred; // bit of the city before
+    };
+    struct Entry {
+        std::uint64_t index;
+        std::uint32_t set;
+        std::uint32_t end;
+    };
+    // survivors of each layer, in index order
+    std::vector<std::vector<State>> layers (m + 1);
+    for (std::uint32_t j = 0; j < m; j++) {
+        layers[1].push_back({std::uint32_t {1} << j, j, d(0, j + 1), static_cast<std::uint32_t>(m)});
+    }
+    size_t widest = 0;
+    for (size_t k = 2; k <= m; k++) {
+        widest = std::max<size_t>(widest, ranks.Count(m, k) * k);
+    }
+    std::vector<std::uint64_t> keys (widest, no_entry);
+    std::vector<std::vector<Entry>> written (num_threads);
+    std::vector<std::vector<State>> survivors (num_threads);
+    for (size_t k = 2; k <= m && !layers[k - 1].empty(); k++) {
+        const auto& alive = layers[k - 1];
+        ParallelFor(alive.size(), num_threads, [&](size_t t, size_t first, size_t last) {
+            written[t].clear();
+            for (size_t s = first; s < last; s++) {
+                const auto [S, j, c, _] = alive[s];
+                for (auto rest = all & ~S; rest; rest &= rest - 1) {
+                    const auto x = static_cast<std::uint32_t>(std::countr_zero(rest));
+                    const std::uint32_t T = S | std::uint32_t {1} << x;
+                    const auto index = ranks.Rank(T) * k + static_cast<size_t>(std::popcount(T & ((std::uint32_t {1} << x) - 1)));
+                    const auto key = Pack(c + d(j + 1, x + 1), j);
+                    bool first_write = false;
+                    if (num_threads == 1) {
+                        first_write = keys[index] == no_entry;
+                        keys[index] = std::min(keys[index], key);
+                    } else {
+                        first_write = AtomicMin(keys[index], key);
+                    }
+                    if (first_write) {
+                        written[t].push_back({index, T, x});
+                    }
+                }
+            }
+        });
+        std::vector<Entry> entries;
+        for (const auto& w : written) {
+            entries.insert(entries.end(), w.begin(), w.end());
+        }
+        std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) { return a.index < b.index; });
+        ParallelFor(entries.size(), num_threads, [&](size_t t, size_t first, size_t last) {
+            survivors[t].clear();
+            std::uint32_t cached = 0;
+            double tree = 0;
+            for (size_t e = first; e < last; e++) {
+                const auto [index, T, x] = entries[e];
+                const auto key = std::exchange(keys[index], no_entry);
+                const double c = Unpack(key);
+                const auto pred = static_cast<std::uint32_t>(key & pred_bits);
+                const std::uint32_t rest = all & ~T;
+                if (!prune || !rest) {
+                    survivors[t].push_back({T, x, c, pred});
+                    continue;
+                }
+                if (T != cached) {
+                    cached = T;
+                    tree = MSTWeight(d, rest);
+                    double enter = std::numeric_limits<double>::max();
+                    for (auto y = rest; y; y &= y - 1) {
+                        enter = std::min(enter, d(0, static_cast<size_t>(std::countr_zero(y)) + 1));
+                    }
+                    tree += enter;
+                }
+                double exit = std::numeric_limits<double>::max();
+                for (auto y = rest; y; y &= y - 1) {
+                    exit = std::min(exit, d(x + 1, static_cast<size_t>(std::countr_zero(y)) + 1));
+                }
+                if (c + tree + exit <= bound) {
+                    survivors[t].push_back({T, x, c, pred});
+                }
+            }
+        });
+        for (const auto& s : survivors) {
+            layers[k].insert(layers[k].end(), s.begin(), s.end());
+        }
+    }
+
+    // close the tour, then follow the predecessors back through the survivors
+    double best = std::numeric_limits<double>::max();
+    State curr {};
+    for (const auto& state : layers[m]) {
+        if (state.cost + d(state.end + 1, 0) < best) {
+            best = state.cost + d(state.end + 1, 0);
+            curr = state;
+        }
+    }
+    if (best == std::numeric_limits<double>::max()) { // nothing beat the heuristic tour
+        return upper;
+    }
+    Tour tour;
+    for (size_t k = m; k >= 1; k--) {
+        tour.order.push_back(curr.end + 1);
+        if (k == 1) {
+            break;
+        }
+        const State prev {curr.set & ~(std::uint32_t {1} << curr.end), curr.pred, 0, 0};
+        auto it = std::lower_bound(layers[k - 1].begin(), layers[k - 1].end(), prev, [&ranks](const auto& a, const auto& b) {
+            const auto ra = ranks.Rank(a.set), rb = ranks.Rank(b.set);
+            return ra < rb || (ra == rb && a.end < b.end);
+        });
+        assert(it != layers[k - 1].end() && it->set == prev.set && it->end == prev.end);
+        curr = *it;
+    }
+    tour.order.push_back(0);
+    std::reverse(tour.order.begin(), tour.order.end());
+    tour.length = TourLength(d, tour.order);
+    return upper.length < tour.length ? upper : tour;
+}
+
+int main() {
+    std::mt19937 gen(std::random_device{}());
+    std::uniform_real_distribution<> coord(0.0, 10'000.0);
+    auto random_stops = [&](size_t n) {
+        std::vector<Point> p (n);
+        for (auto& [x, y] : p) {
+            x = coord(gen);
+            y = coord(gen);
+        }
+        return Distances(p);
+    };
+    auto is_tour = [](const Tour& tour, size_t n) {
+        auto order = tour.order;
+        std::sort(order.begin(), order.end());
+        return tour.order.size() == n && tour.order[0] == 0 && std::adjacent_find(order.begin(), order.end()) == order.end() &&
+               (order.empty() || order.back() == n - 1);
+    };
+
+    for (size_t iter = 0; iter < 200; iter++) {
+        const size_t n = 1 + iter % 9;
+        auto d = random_stops(n);
+        auto expected = BruteForceTSP(d);
+        for (size_t threads : {1, 3}) {
+            for (bool prune : {false, true}) {
+                auto tour = HeldKarp(d, threads, prune);
+                assert(is_tour(tour, n));
+                assert(std::abs(tour.length - expected.length) <= 1e-9 * std::max(1.0, expected.length));
+            }
+        }
+    }
+    for (size_t iter = 0; iter < 20; iter++) {
+        const size_t n = 10 + iter % 6;
+        auto d = random_stops(n);
+        auto plain = HeldKarp(d, 1, false);
+        auto pruned = HeldKarp(d, 4, true);
+        assert(is_tour(pruned, n));
+        assert(std::abs(plain.length - pruned.length) <= 1e-9 * plain.length);
+        auto approx = ApproxTSPTour(d);
+        assert(approx.length <= 2 * plain.length + 1e-9);
+    }
+
+    const size_t threads = std::thread::hardware_concurrency();
+    for (size_t n : {16, 20, 23, 25}) {
+        auto d = random_stops(n);
+        auto t1 = crn::steady_clock::now();
+        auto approx = LocalSearchTour(d);
+        auto t2 = crn::steady_clock::now();
+        auto tour = HeldKarp(d, threads);
+        auto t3 = crn::steady_clock::now();
+        std::cout << n << " stops, optimal tour " << tour.length << ", local search " << approx.length << '\n';
+        std::cout << "Local search : " << crn::duration_cast<crn::microseconds>(t2 - t1).count() << "us\n";
+        std::cout << "Held-Karp with MST pruning : " << crn::duration_cast<crn::milliseconds>(t3 - t2).count() << "ms\n";
+        if (n <= 20) {
+            auto plain = HeldKarp(d, threads, false);
+            auto t4 = crn::steady_clock::now();
+            assert(std::abs(plain.length - tour.length) <= 1e-9 * tour.length);
+            std::cout << "Held-Karp : " << crn::duration_cast<crn::milliseconds>(t4 - t3).count() << "ms\n";
+        }
+    }
+}
@@ -0,0 +1,219 @@
+#include <algorithm>
+#include <barrier>
+#include <bit>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <ranges>
+#include <thread>
+#include <vector>
+
+namespace crn = std::chrono;
+namespace sr = std::ranges;
+
+std::size_t ExactSubsetSum(const std::vector<std::size_t>& S, std::size_t t) {
+    std::vector<std::size_t> L {0};
+    for (auto s : S) {
+        auto L_plus = L;
+        sr::for_each(L_plus, [&s](auto& e){e += s;});
+        std::vector<std::size_t> L_next;
+        sr::merge(L, L_plus, std::back_inserter(L_next));
+        std::swap(L, L_next);
+        L.erase(sr::upper_bound(L, t), L.end());
+    }
+    return L.back();
+}
+
+constexpr std::size_t block = 8; // words per fixed-length inner loop, so gcc vectorizes it at -O2
+
+// records item for every bit of dst that is not in src, in words [a, b)
+void RecordNew(const std::uint64_t* src, const std::uint64_t* dst, std::uint32_t* first, std::uint32_t item,
+               std::size_t a, std::size_t b) {
+    for (std::size_t k = a; k < b; k++) {
+        for (auto diff = dst[k] & ~src[k]; diff; diff &= diff - 1) {
+            first[k * 64 + static_cast<std::size_t>(std::countr_zero(diff))] = item;
+        }
+    }
+}
+
+// dst = src | src << (64 q + r) over words [a, b), with a > q, recording new bits block by block
+void ShiftOr(const std::uint64_t* __restrict src, std::uint64_t* __restrict dst, std::uint32_t* first, std::uint32_t item,
+             std::size_t q, unsigned r, std::size_t a, std::size_t b) {
+    auto word = [&](std::size_t k) {
+        // (x >> 1) >> (63 - r) is x >> (64 - r), and 0 for r == 0
+        return src[k] | src[k - q] << r | (src[k - q - 1] >> 1) >> (63 - r);
+    };
+    std::size_t k = a;
+    for (; k + block <= b; k += block) {
+        std::uint64_t changed = 0;
+        for (std::size_t e = 0; e < block; e++) {
+            const std::uint64_t w = word(k + e);
+            dst[k + e] = w;
+            changed |= w ^ src[k + e];
+        }
+        if (changed) {
+            RecordNew(src, dst, first, item, k, k + block);
+        }
+    }
+    const std::size_t tail = k;
+    for (; k < b; k++) {
+        dst[k] = word(k);
+    }
+    RecordNew(src, dst, first, item, tail, b);
+}
+
+struct SubsetSum {
+    std::size_t sum = 0;
+    std::vector<std::size_t> items; // indices into S, increasing
+};
+
+// reachable sums as a bitset of t + 1 bits, each item a shift-or of the whole set. the bits an
+// item sets first record that item, so sum s came from s - S[first[s]], which was reachable
+// with earlier items only, and the chain of first[] reconstructs the subset in O(t) extra
+// space. words below the first one with a zero bit and above the largest sum so far are left
+// alone, the scan stops once t is reached, and the words of every item are split across
+// threads (double buffered, so slices never read words another thread is writing).
+SubsetSum BitsetSubsetSum(const std::vector<std::size_t>& S, std::size_t t,
+                          std::size_t num_threads = std::thread::hardware_concurrency()) {
+    // every sum is a multiple of the gcd g of the weights, so solve S / g against t / g
+    std::size_t g = 0;
+    for (auto s : S) {
+        if (s && s <= t) {
+            g = std::gcd(g, s);
+        }
+    }
+    if (g > 1) {
+        std::vector<std::size_t> scaled (S.size());
+        for (std::size_t i = 0; i < S.size(); i++) {
+            scaled[i] = S[i] && S[i] <= t ? S[i] / g : (S[i] ? t / g + 1 : 0);
+        }
+        auto res = BitsetSubsetSum(scaled, t / g, num_threads);
+        res.sum *= g;
+        return res;
+    }
+    const std::size_t words = t / 64 + 1;
+    num_threads = std::clamp<std::size_t>(num_threads, 1, std::max<std::size_t>(words / 256, 1));
+    std::vector<std::uint64_t> curr (words), next (words);
+    std::vector<std::uint32_t> first (words * 64);
+    assert(S.size() < (std::size_t {1} << 32));
+    curr[0] = next[0] = 1;
+    std::size_t full = 0;       // words [0, full) of curr are all ones
+    std::size_t full_prev = 0;  // and of next
+    std::size_t reach = 0;      // largest sum of all items so far, capped at t
+    std::size_t item = 0;
+    auto skip = [&] {
+        while (item < S.size() && (S[item] == 0 || S[item] > t)) {
+            item++;
+        }
+    };
+    skip();
+    auto done = [&] {
+        return item == S.size() || (curr[t / 64] >> (t % 64) & 1);
+    };
+    std::barrier sync (static_cast<std::ptrdiff_t>(num_threads), [&]() noexcept {
+        std::swap(curr, next);
+        std::swap(full, full_prev);
+        full = std::max(full, full_prev);
+        while (full < words && curr[full] == ~std::uint64_t {0}) {
+            full++;
+        }
+        reach = std::min(t, reach + S[item]);
+        item++;
+        skip();
+    });
+    auto worker = [&](std::size_t id) {
+        while (!done()) {
+            const std::size_t s = S[item];
+            const std::size_t q = s / 64;
+            const auto r = static_cast<unsigned>(s % 64);
+            // words that can change: next lags curr by an item, so start from its full prefix
+            const std::size_t lo = std::min(full, full_prev);
+            const std::size_t hi = std::min(t, reach + s) / 64 + 1;
+            const std::size_t a = lo + (hi - lo) * id / num_threads;
+            const std::size_t b = lo + (hi - lo) * (id + 1) / num_threads;
+            const std::size_t split = std::clamp(q + 1, a, b); // words below have no complete source
+            for (std::size_t k = a; k < split; k++) {
+                next[k] = curr[k] | (k >= q ? curr[k - q] << r : 0);
+            }
+            RecordNew(curr.data(), next.data(), first.data(), static_cast<std::uint32_t>(item), a, split);
+            if (split < b) {
+                ShiftOr(curr.data(), next.data(), first.data(), static_cast<std::uint32_t>(item), q, r, split, b);
+            }
+            sync.arrive_and_wait();
+        }
+    };
+    {
+        std::vector<std::jthread> threads;
+        for (std::size_t id = 1; id < num_threads; id++) {
+            threads.emplace_back(worker, id);
+        }
+        worker(0);
+    }
+    SubsetSum res;
+    for (res.sum = t; !(curr[res.sum / 64] >> (res.sum % 64) & 1); res.sum--) {
+    }
+    for (std::size_t s = res.sum; s;) {
+        res.items.push_back(first[s]);
+        s -= S[first[s]];
+    }
+    sr::reverse(res.items);
+    return res;
+}
+
+int main() {
+    std::vector<std::size_t> S {104, 102, 201, 101};
+    std::size_t t = 308;
+    auto exact_ss = ExactSubsetSum(S, t);
+    auto bitset_ss = BitsetSubsetSum(S, t);
+    std::cout << exact_ss << ' ' << bitset_ss.sum << '\n';
+    assert(exact_ss == bitset_ss.sum);
+
+    std::mt19937 gen(std::random_device{}());
+    auto check = [&S](const SubsetSum& res, std::size_t t) {
+        std::size_t sum = 0;
+        for (std::size_t i = 0; i < res.items.size(); i++) {
+            assert(res.items[i] < S.size() && (i == 0 || res.items[i - 1] < res.items[i]));
+            sum += S[res.items[i]];
+        }
+        assert(sum == res.sum && sum <= t);
+    };
+    for (std::size_t iter = 0; iter < 300; iter++) {
+        S.resize(gen() % 16);
+        const std::size_t range = iter % 3 ? 1000 : 100'000;
+        for (auto& s : S) {
+            s = gen() % range;
+        }
+        t = gen() % (range * 4 + 1);
+        auto expected = ExactSubsetSum(S, t);
+        for (std::size_t threads : {1, 2, 5}) {
+            auto res = BitsetSubsetSum(S, t, threads);
+            assert(res.sum == expected);
+            check(res, t);
+        }
+    }
+
+    // 10^4 weights against targets near 10^7: weights of mixed parity, then multiples of 3 with
+    // an unreachable target, then weights of a million and up
+    S.resize(10'000);
+    for (std::size_t round = 0; round < 3; round++) {
+        for (auto& s : S) {
+            s = round == 0 ? 1 + gen() % 9000 : round == 1 ? 3 * (1 + gen() % 3000) : 1'000'000 + gen() % 1'000'000;
+        }
+        const std::size_t target = 10'000'000;
+        auto t1 = crn::steady_clock::now();
+        auto res = BitsetSubsetSum(S, target, 1);
+        auto t2 = crn::steady_clock::now();
+        auto parallel = BitsetSubsetSum(S, target, 4);
+        auto t3 = crn::steady_clock::now();
+        check(res, target);
+        check(parallel, target);
+        assert(res.sum == parallel.sum);
+        std::cout << "t = " << target << ", sum " << res.sum << " from " << res.items.size() << " items\n";
+        std::cout << "Bitset subset sum : " << crn::duration_cast<crn::milliseconds>(t2 - t1).count() << "ms\n";
+        std::cout << "Bitset subset sum on 4 threads : " << crn::duration_cast<crn::milliseconds>(t3 - t2).count() << "ms\n";
+    }
+}
@@ -0,0 +1,322 @@
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <ranges>
+
+namespace sr = std::ranges;
+namespace crn = std::chrono;
+
+std::mt19937 gen(std::random_device{}());
+
+static const std::string chars = "abcdefghijklmnopqrstuvwxyz";
+
+void bucketSort(std::vector<std::string>& A, size_t pos) {
+    if (pos == 5) {
+        return;
+    }
+    std::vector<std::vector<std::string>> B (27);
+    for (const auto& str : A) {
+        if (str.size() <= pos) {
+            B[0].push_back(str);
+        } else {
+            B[1 + str[pos] - 'a'].push_back(str);
+        }
+    }
+    for (size_t i = 0; i < 27; i++) {
+        bucketSort(B[i], pos + 1);
+    }
+    A.clear();
+    for (auto& v : B) {
+        A.insert(A.end(), std::make_move_iterator(v.begin()), std::make_move_iterator(v.end()));
+    }
+}
+
+std::string make_random_string() {
+    std::string res;
+    std::uniform_int_distribution<> char_dist(0, 25);
+    std::uniform_int_distribution<> length_dist(1, 5);
+    size_t l = length_dist(gen);
+    for (size_t i = 0; i < l; i++) {
+        res += chars[char_dist(gen)];
+    }
+    return res;
+}
+
+// a string being sorted: its characters and its position in the input
+struct StringKey {
+    const char* data;
+    std::uint32_t size;
+    std::uint32_t index;
+};
+
+// bucket of a string at depth: 0 past its end, else the byte + 1, so prefixes come first
+constexpr size_t alphabet = 257;
+
+std::uint16_t charAt(const StringKey& s, size_t depth) {
+    return depth < s.size ? static_cast<std::uint16_t>(static_cast<unsigned char>(s.data[depth]) + 1) : 0;
+}
+
+// strings that agree on their first depth characters
+void insertionSort(StringKey* A, size_t n, size_t depth) {
+    auto suffix = [depth](const StringKey& s) {
+        return std::string_view(s.data + depth, s.size - depth);
+    };
+    for (size_t j = 1; j < n; j++) {
+        auto key = A[j];
+        size_t i = j - 1;
+        while (i < n && suffix(key) < suffix(A[i])) {
+            A[i + 1] = A[i];
+            i--;
+        }
+        A[i + 1] = key;
+    }
+}
+
+// Bentley and Sedgewick: a three-way partition on the character at depth, and only the middle
+// part moves on to the next character
+void multikeyQuicksort(StringKey* A, size_t n, size_t depth) {
+    while (n > 16) {
+        std::uint16_t a = charAt(A[0], depth), b = charAt(A[n / 2], depth), c = charAt(A[n - 1], depth);
+        const std::uint16_t pivot = std::max(std::min(a, b), std::min(std::max(a, b), c));
+        size_t lt = 0, i = 0, gt = n;
+        while (i < gt) {
+            const auto ch = charAt(A[i], depth);
+            if (ch < pivot) {
+                std::swap(A[lt++], A[i++]);
+            } else if (ch > pivot) {
+                std::swap(A[i], A[--gt]);
+            } else {
+                i++;
+            }
+        }
+        multikeyQuicksort(A, lt, depth);
+        multikeyQuicksort(A + gt, n - gt, depth);
+        if (pivot == 0) { // the middle part ended together
+            return;
+        }
+        A += lt;
+        n = gt - lt;
+        depth++;
+    }
+    insertionSort(A, n, depth);
+}
+
+constexpr size_t flag_cutoff = 512; // below this a 257-bucket pass costs more than it saves
+
+// one American flag pass at depth over A[0, n): the character of every string is read once
+// into cache, counted, and the strings are permuted into their buckets in place by following
+// cycles, with cache permuted alongside. returns the bucket bounds and moves depth past any
+// prefix that all strings share, which would otherwise cost one pass per character.
+std::array<size_t, alphabet + 1> flagPass(StringKey* A, std::uint16_t* cache, size_t n, size_t& depth) {
+    std::array<size_t, alphabet + 1> start {};
+    while (true) {
+        std::array<size_t, alphabet> count {};
+        for (size_t i = 0; i < n; i++) {
+            cache[i] = charAt(A[i], depth);
+            count[cache[i]]++;
+        }
+        if (count[cache[0]] == n && cache[0] != 0) { // a shared character: skip the whole shared prefix
+            size_t common = A[0].size;
+            for (size_t i = 1; i < n && common > depth; i++) {
+                const size_t len = std::min<size_t>(common, A[i].size) - depth;
+                common = static_cast<size_t>(std::mismatch(A[0].data + depth, A[0].data + depth + len, A[i].data + depth).first - A[0].data);
+            }
+            depth = common;
+            continue;
+        }
+        for (size_t b = 0; b < alphabet; b++) {
+            start[b + 1] = start[b] + count[b];
+        }
+        break;
+    }
+    std::array<size_t, alphabet> next;
+    std::copy_n(start.begin(), alphabet, next.begin());
+    for (size_t b = 0; b < alphabet; b++) {
+        while (next[b] < start[b + 1]) {
+            const size_t pos = next[b];
+            auto s = A[pos];
+            auto c = cache[pos];
+            while (c != b) { // carry s to its bucket, picking up what was there
+                const size_t dst = next[c]++;
+                std::swap(s, A[dst]);
+                std::swap(c, cache[dst]);
+            }
+            A[pos] = s;
+            cache[pos] = c;
+            next[b]++;
+        }
+    }
+    return start;
+}
+
+void americanFlagSort(StringKey* A, std::uint16_t* cache, size_t n, size_t depth) {
+    if (n < flag_cutoff) {
+        multikeyQuicksort(A, n, depth);
+        return;
+    }
+    const auto start = flagPass(A, cache, n, depth);
+    for (size_t b = 1; b < alphabet; b++) {
+        americanFlagSort(A + start[b], cache + start[b], start[b + 1] - start[b], depth + 1);
+    }
+}
+
+// MSD radix sort of strings by American flag passes, multikey quicksort below flag_cutoff.
+// buckets of at least `grain` strings go to a shared stack that all threads take work from;
+// smaller ones are sorted by the thread that split them off.
+void americanFlagSort(std::vector<std::string>& A, size_t num_threads = std::thread::hardware_concurrency()) {
+    const size_t n = A.size();
+    assert(n < std::numeric_limits<std::uint32_t>::max());
+    std::vector<StringKey> keys (n);
+    for (size_t i = 0; i < n; i++) {
+        assert(A[i].size() < std::numeric_limits<std::uint32_t>::max());
+        keys[i] = {A[i].data(), static_cast<std::uint32_t>(A[i].size()), static_cast<std::uint32_t>(i)};
+    }
+    std::vector<std::uint16_t> cache (n);
+    num_threads = std::clamp<size_t>(num_threads, 1, std::max<size_t>(n / 65536, 1));
+    if (num_threads == 1) {
+        americanFlagSort(keys.data(), cache.data(), n, 0);
+    } else {
+        struct Task {
+            size_t first;
+            size_t size;
+            size_t depth;
+        };
+        const size_t grain = std::max<size_t>(n / (16 * num_threads), 65536);
+        std::vector<Task> tasks {{0, n, 0}};
+        size_t busy = 0;
+        std::mutex m;
+        std::condition_variable cv;
+        auto worker = [&] {
+            while (true) {
+                Task task;
+                {
+                    std::unique_lock lock (m);
+                    cv.wait(lock, [&] { return !tasks.empty() || busy == 0; });
+                    if (tasks.empty()) {
+                        return;
+                    }
+                    task = tasks.back();
+                    tasks.pop_back();
+                    busy++;
+                }
+                auto [first, size, depth] = task;
+                if (size < grain) {
+                    americanFlagSort(keys.data() + first, cache.data() + first, size, depth);
+                } else {
+                    const auto start = flagPass(keys.data() + first, cache.data() + first, size, depth);
+                    {
+                        std::lock_guard lock (m);
+                        for (size_t b = 1; b < alphabet; b++) {
+                            if (start[b + 1] - start[b] >= grain) {
+                                tasks.push_back({first + start[b], start[b + 1] - start[b], depth + 1});
+                            }
+                        }
+                    }
+                    cv.notify_all();
+                    for (size_t b = 1; b < alphabet; b++) {
+                        if (start[b + 1] - start[b] < grain) {
+                            americanFlagSort(keys.data() + first + start[b], cache.data() + first + start[b],
+                                             start[b + 1] - start[b], depth + 1);
+                        }
+                    }
+                }
+                {
+                    std::lock_guard lock (m);
+                    busy--;
+                }
+                cv.notify_all();
+            }
+        };
+        std::vector<std::jthread> threads;
+        for (size_t t = 1; t < num_threads; t++) {
+            threads.emplace_back(worker);
+        }
+        worker();
+    }
+    std::vector<std::string> sorted (n);
+    for (size_t i = 0; i < n; i++) {
+        sorted[i] = std::move(A[keys[i].index]);
+    }
+    A.swap(sorted);
+}
+
+// URLs over a few hosts and path words, so that most comparisons run through long prefixes
+std::string make_random_url() {
+    static const std::vector<std::string> hosts {"https://www.example.com/", "https://www.example.org/",
+                                                 "https://cdn.example.com/static/", "http://blog.example.net/",
+                                                 "https://shop.example.com/catalog/"};
+    static const std::vector<std::string> words {"index", "products", "search", "user", "profile", "images",
+                                                 "2023", "2024", "article", "news", "video", "watch"};
+    std::string res = hosts[gen() % hosts.size()];
+    for (size_t k = 1 + gen() % 4; k > 0; k--) {
+        res += words[gen() % words.size()];
+        res += '/';
+    }
+    res += "item?id=" + std::to_string(gen() % 10'000'000);
+    return res;
+}
+
+int main() {
+    constexpr size_t N = 100;
+    std::vector<std::string> A;
+    for (size_t i = 0; i < N; i++) {
+        A.push_back(make_random_string());
+    }
+    auto B = A;
+    bucketSort(A, 0);
+    americanFlagSort(B);
+    assert(A == B);
+
+    for (size_t t = 0; t < 100; t++) {
+        std::vector<std::string> C (t % 10 == 0 ? 200'000 : gen() % 5000);
+        for (auto& s : C) {
+            s.resize(gen() % 12);
+            for (auto& c : s) {
+                c = static_cast<char>(t % 2 ? 'a' + gen() % 3 : gen() % 256); // few letters, or any byte
+            }
+            if (t % 3 == 0) {
+                s = "common/prefix/" + s;
+            }
+        }
+        auto expected = C;
+        sr::sort(expected);
+        americanFlagSort(C, 1 + t % 4);
+        assert(C == expected);
+    }
+
+    constexpr size_t URLS = 3'000'000;
+    std::vector<std::string> urls (URLS);
+    for (auto& url : urls) {
+        url = make_random_url();
+    }
+    const size_t threads = std::thread::hardware_concurrency();
+    auto D = urls;
+    auto t1 = crn::steady_clock::now();
+    sr::sort(D);
+    auto t2 = crn::steady_clock::now();
+    auto E = urls;
+    auto t3 = crn::steady_clock::now();
+    americanFlagSort(E, 1);
+    auto t4 = crn::steady_clock::now();
+    assert(E == D);
+    E = urls;
+    auto t5 = crn::steady_clock::now();
+    americanFlagSort(E, threads);
+    auto t6 = crn::steady_clock::now();
+    assert(E == D);
+
+    std::cout << "Sorting " << URLS << " URLs using std::sort : " << crn::duration_cast<crn::milliseconds>(t2 - t1).count() << "ms\n";
+    std::cout << "Sorting " << URLS << " URLs using American flag sort : " << crn::duration_cast<crn::milliseconds>(t4 - t3).count() << "ms\n";
+    std::cout << "Sorting " << URLS << " URLs using American flag sort on " << threads << " threads : " << crn::duration_cast<crn::milliseconds>(t6 - t5).count() << "ms\n";
+}
@@ -0,0 +1,297 @@
+#include <algorithm>
+#include <array>
+#include <barrier>
+#include <bit>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <ranges>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sr = std::ranges;
+namespace crn = std::chrono;
+
+std::mt19937 gen(std::random_device{}());
+
+// the unsigned integer whose order is the order of key: signed integers flip the sign bit,
+// floating point numbers flip every bit of negatives and only the sign bit of the rest
+template <typename K>
+auto radixKey(K key) {
+    if constexpr (std::is_floating_point_v<K>) {
+        using U = std::conditional_t<sizeof(K) == 4, std::uint32_t, std::uint64_t>;
+        const auto u = std::bit_cast<U>(key);
+        constexpr U sign = U {1} << (8 * sizeof(U) - 1);
+        return u & sign ? static_cast<U>(~u) : static_cast<U>(u | sign);
+    } else if constexpr (std::is_signed_v<K>) {
+        using U = std::make_unsigned_t<K>;
+        return static_cast<U>(static_cast<U>(key) ^ (U {1} << (8 * sizeof(U) - 1)));
+    } else {
+        return key;
+    }
+}
+
+// LSD radix sort: one counting sort per digit of Bits bits, least significant first, between
+// A and a buffer. one read of A counts every digit; a digit that is the same for all keys
+// skips its pass. each pass splits A into one chunk per thread: every thread counts its
+// chunk, then derives its own write offsets from the counts of all threads (bucket by bucket
+// the chunks keep their order, so the sort stays stable), then scatters its chunk. values, if
+// any, move with their keys.
+template <unsigned Bits, typename K, typename V = std::nullptr_t>
+void lsdRadixSortImpl(std::vector<K>& A, std::vector<V>* values, size_t num_threads) {
+    constexpr bool with_values = !std::is_same_v<V, std::nullptr_t>;
+    constexpr size_t buckets = size_t {1} << Bits;
+    constexpr size_t mask = buckets - 1;
+    constexpr unsigned key_bits = 8 * sizeof(K);
+    constexpr unsigned passes = (key_bits + Bits - 1) / Bits;
+    constexpr size_t stage = std::max<size_t>(256 / sizeof(K), 1); // keys staged per bucket
+    const size_t n = A.size();
+    if (n < 2) {
+        return;
+    }
+    num_threads = std::clamp<size_t>(num_threads, 1, std::max<size_t>(n / 65536, 1));
+    auto digit = [](const K& key, unsigned pass) {
+        return static_cast<size_t>(radixKey(key) >> (pass * Bits)) & mask;
+    };
+
+    // every digit counted in one read, to find the passes that move nothing
+    std::vector<std::array<size_t, buckets>> total (passes);
+    {
+        std::vector<std::vector<std::array<size_t, buckets>>> counts (num_threads, std::vector<std::array<size_t, buckets>> (passes));
+        auto worker = [&](size_t t) {
+            auto& count = counts[t];
+            for (size_t i = n * t / num_threads; i < n * (t + 1) / num_threads; i++) {
+                const auto key = radixKey(A[i]);
+                for (unsigned p = 0; p < passes; p++) {
+                    count[p][static_cast<size_t>(key >> (p * Bits)) & mask]++;
+                }
+            }
+        };
+        {
+            std::vector<std::jthread> threads;
+            for (size_t t = 1; t < num_threads; t++) {
+                threads.emplace_back(worker, t);
+            }
+            worker(0);
+        }
+        for (unsigned p = 0; p < passes; p++) {
+            total[p].fill(0);
+            for (size_t t = 0; t < num_threads; t++) {
+                for (size_t b = 0; b < buckets; b++) {
+                    total[p][b] += counts[t][p][b];
+                }
+            }
+        }
+    }
+    std::vector<unsigned> todo;
+    for (unsigned p = 0; p < passes; p++) {
+        if (sr::find(total[p], n) == total[p].end()) {
+            todo.push_back(p);
+        }
+    }
+    if (todo.empty()) {
+        return;
+    }
+
+    std::vector<K> B (n);
+    std::vector<V> values_B;
+    if constexpr (with_values) {
+        assert(values->size() == n);
+        values_B.resize(n);
+    }
+    K* src = A.data();
+    K* dst = B.data();
+    V* vsrc = nullptr;
+    V* vdst = nullptr;
+    if constexpr (with_values) {
+        vsrc = values->data();
+        vdst = values_B.data();
+    }
+    std::vector<std::array<size_t, buckets>> count (num_threads);
+    size_t step = 0;
+    std::barrier counted (static_cast<std::ptrdiff_t>(num_threads));
+    std::barrier scattered (static_cast<std::ptrdiff_t>(num_threads), [&]() noexcept {
+        std::swap(src, dst);
+        std::swap(vsrc, vdst);
+        step++;
+    });
+    auto worker = [&](size_t t) {
+        const size_t first = n * t / num_threads;
+        const size_t last = n * (t + 1) / num_threads;
+        std::array<size_t, buckets> offset;
+        std::vector<std::uint32_t> fill (buckets);
+        std::vector<K> staged (buckets * stage);
+        std::vector<V> staged_values (with_values ? buckets * stage : 0);
+        while (step < todo.size()) {
+            const unsigned p = todo[step];
+            if (num_threads == 1) {
+                count[0] = total[p];
+            } else {
+                count[t].fill(0);
+                for (size_t i = first; i < last; i++) {
+                    count[t][digit(src[i], p)]++;
+                }
+                counted.arrive_and_wait();
+            }
+            // offset[b]: keys of lower buckets, then bucket b in the chunks before this one
+            size_t sum = 0;
+            for (size_t b = 0; b < buckets; b++) {
+                offset[b] = sum;
+                for (size_t u = 0; u < t; u++) {
+                    offset[b] += count[u][b];
+                }
+                sum += total[p][b];
+            }
+            // keys are staged per bucket and written out a few cache lines at a time: a direct
+            // scatter into 2^Bits places at once misses the TLB on nearly every write
+            auto flush = [&](size_t b, size_t len) {
+                std::copy_n(staged.begin() + static_cast<std::ptrdiff_t>(b * stage), len, dst + offset[b]);
+                if constexpr (with_values) {
+                    std::move(staged_values.begin() + static_cast<std::ptrdiff_t>(b * stage),
+                              staged_values.begin() + static_cast<std::ptrdiff_t>(b * stage + len), vdst + offset[b]);
+                }
+                offset[b] += len;
+            };
+            for (size_t i = first; i < last; i++) {
+                const size_t b = digit(src[i], p);
+                staged[b * stage + fill[b]] = src[i];
+                if constexpr (with_values) {
+                    staged_values[b * stage + fill[b]] = std::move(vsrc[i]);
+                }
+                if (++fill[b] == stage) {
+                    flush(b, stage);
+                    fill[b] = 0;
+                }
+            }
+            for (size_t b = 0; b < buckets; b++) {
+                flush(b, fill[b]);
+                fill[b] = 0;
+            }
+            scattered.arrive_and_wait();
+        }
+    };
+    {
+        std::vector<std::jthread> threads;
+        for (size_t t = 1; t < num_threads; t++) {
+            threads.emplace_back(worker, t);
+        }
+        worker(0);
+    }
+    if (src != A.data()) { // an odd number of passes ran
+        A.swap(B);
+        if constexpr (with_values) {
+            values->swap(values_B);
+        }
+    }
+}
+
+// 11-bit digits: 3 passes for 32-bit keys and 6 for 64-bit ones. with the staged scatter,
+// fewer passes over 2048 buckets beat more passes over 256
+template <typename K>
+constexpr unsigned defaultDigitBits = sizeof(K) <= 2 ? 8 : 11;
+
+template <typename K, unsigned Bits = defaultDigitBits<K>>
+void lsdRadixSort(std::vector<K>& A, size_t num_threads = std::thread::hardware_concurrency()) {
+    static_assert(std::is_arithmetic_v<K>);
+    lsdRadixSortImpl<Bits, K, std::nullptr_t>(A, nullptr, num_threads);
+}
+
+// sorts keys and moves values[i] along with keys[i], stably
+template <typename K, typename V, unsigned Bits = defaultDigitBits<K>>
+void lsdRadixSort(std::vector<K>& keys, std::vector<V>& values, size_t num_threads = std::thread::hardware_concurrency()) {
+    static_assert(std::is_arithmetic_v<K>);
+    lsdRadixSortImpl<Bits, K, V>(keys, &values, num_threads);
+}
+
+template <typename K>
+void checkSort(std::vector<K> A, size_t num_threads) {
+    auto expected = A;
+    sr::sort(expected);
+    lsdRadixSort(A, num_threads);
+    assert(sr::equal(A, expected, [](K a, K b) { return !(a < b) && !(b < a); }));
+}
+
+int main() {
+    for (size_t t = 0; t < 100; t++) {
+        const size_t n = t % 10 == 0 ? 300'000 : gen() % 3000;
+        const size_t threads = 1 + t % 4;
+        std::vector<std::uint32_t> u32 (n);
+        std::vector<std::uint64_t> u64 (n);
+        std::vector<std::int32_t> i32 (n);
+        std::vector<std::int64_t> i64 (n);
+        std::vector<float> f32 (n);
+        std::vector<double> f64 (n);
+        for (size_t i = 0; i < n; i++) {
+            u32[i] = t % 3 ? static_cast<std::uint32_t>(gen()) : static_cast<std::uint32_t>(gen() % 1000); // skipped passes
+            u64[i] = static_cast<std::uint64_t>(gen()) << 32 | gen();
+            i32[i] = static_cast<std::int32_t>(gen());
+            i64[i] = static_cast<std::int64_t>(u64[i]) >> (t % 40);
+            f32[i] = std::uniform_real_distribution<float>(-1e6f, 1e6f)(gen);
+            f64[i] = std::normal_distribution<double>(0.0, t % 2 ? 1e-300 : 1e300)(gen);
+        }
+        checkSort(u32, threads);
+        checkSort(u64, threads);
+        checkSort(i32, threads);
+        checkSort(i64, threads);
+        checkSort(f32, threads);
+        checkSort(f64, threads);
+        f64.push_back(std::numeric_limits<double>::infinity());
+        f64.push_back(-std::numeric_limits<double>::infinity());
+        f64.push_back(-0.0);
+        checkSort(f64, threads);
+
+        // stable with values: keys with many ties, values their original positions
+        auto keys = u32;
+        for (auto& k : keys) {
+            k %= 100;
+        }
+        std::vector<size_t> values (n);
+        for (size_t i = 0; i < n; i++) {
+            values[i] = i;
+        }
+        auto expected = keys;
+        sr::sort(expected);
+        const auto original = keys;
+        lsdRadixSort(keys, values, threads);
+        assert(keys == expected);
+        for (size_t i = 0; i < n; i++) {
+            assert(original[values[i]] == keys[i] && (i == 0 || keys[i - 1] < keys[i] || values[i - 1] < values[i]));
+        }
+    }
+
+    constexpr size_t N = 100'000'000;
+    std::vector<std::uint64_t> A (N);
+    for (auto& n : A) {
+        n = static_cast<std::uint64_t>(gen()) << 32 | gen();
+    }
+    auto B = A;
+    const size_t threads = std::thread::hardware_concurrency();
+    auto t1 = crn::steady_clock::now();
+    sr::sort(B);
+    auto t2 = crn::steady_clock::now();
+    auto C = A;
+    auto t3 = crn::steady_clock::now();
+    lsdRadixSort<std::uint64_t, 8>(C, 1);
+    auto t4 = crn::steady_clock::now();
+    assert(C == B);
+    C = A;
+    auto t5 = crn::steady_clock::now();
+    lsdRadixSort(C, 1);
+    auto t6 = crn::steady_clock::now();
+    assert(C == B);
+    C = A;
+    auto t7 = crn::steady_clock::now();
+    lsdRadixSort(C, threads);
+    auto t8 = crn::steady_clock::now();
+    assert(C == B);
+
+    std::cout << "Sorting " << N << " uint64 keys using std::sort : " << crn::duration_cast<crn::milliseconds>(t2 - t1).count() << "ms\n";
+    std::cout << "Sorting " << N << " uint64 keys using LSD radix sort, 8-bit digits : " << crn::duration_cast<crn::milliseconds>(t4 - t3).count() << "ms\n";
+    std::cout << "Sorting " << N << " uint64 keys using LSD radix sort, 11-bit digits : " << crn::duration_cast<crn::milliseconds>(t6 - t5).count() << "ms\n";
+    std::cout << "Sorting " << N << " uint64 keys using LSD radix sort on " << threads << " threads : " << crn::duration_cast<crn::milliseconds>(t8 - t7).count() << "ms\n";
+}